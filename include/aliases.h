@@ -0,0 +1,68 @@
+/*!	\file aliases.h
+*	\brief Speaker alias resolution header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: aliases.h\n
+*   \b Purpose: Define a class that maps raw speaker names to canonical, interned speaker IDs.\n
+*   \n
+*   A raw name is normalized by trimming it, collapsing runs of whitespace, lowercasing it and dropping a leading
+*   honorific such as "Sec." or "Senator". The normalized key is looked up in the alias table, which is read from a
+*   text file of "variant = Canonical Name" lines. Names with no alias keep their own spelling. \n
+*   Each canonical name is interned once and identified by an int. Results are cached by raw name, so a name seen
+*   before costs one hash lookup. \n
+*   suggest() looks for likely aliases that the table does not cover yet, using a trigram index to find candidate
+*   pairs and a bounded edit distance or initials check to confirm them.
+*
+*/
+
+#ifndef ALIASES_H
+#define ALIASES_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <istream>
+
+using namespace std;
+
+//a probable alias not in the table
+struct aliasSuggestion{
+    int variant = -1;       //less used name
+    int canonical = -1;     //more used name
+    int distance = 0;       //edit distance between the normalized names, -1 for an initials match
+};
+
+
+class aliasResolver{
+    private:
+        unordered_map<string, string> aliases;  //normalized variant -> canonical spelling
+        unordered_map<string, int> rawCache;    //raw name -> id
+        unordered_map<string, int> ids;         //normalized canonical name -> id
+        vector<string> names;                   //id -> canonical spelling
+        vector<long> uses;                      //id -> speeches read under the name at ingest
+
+        int intern(const string&);
+
+    public:
+        int load(istream&);
+        int loadFile(const string&);
+        void clear();
+
+        int resolve(const string&);
+        void countUse(int);
+        const string& getName(int) const;
+        int getCount() const;
+        long getUses(int) const;
+        size_t getAliasCount() const;
+
+        vector<aliasSuggestion> suggest(int = 2) const;
+
+        static string normalize(string_view);
+        static string tidy(string_view);
+        static int editDistance(const string&, const string&, int);
+
+        static aliasResolver& shared();
+};
+
+#endif
@@ -0,0 +1,97 @@
+/*!	\file compare.h
+*	\brief Event comparison header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: compare.h\n
+*   \b Purpose: Define dense per-event statistics and the similarity measures used to compare events.\n
+*   \n
+*   Each event becomes one row of several matrices. The speaker matrices hold word count, speaking time, turns and
+*   share of the event's speaking time (of its words, if the event has no lengths), with one column per interned
+*   speaker id. The vocabulary matrix holds word frequencies hashed into a fixed number of buckets, normalized to
+*   sum to one. \n
+*   Events are compared by the cosine similarity and Jensen-Shannon divergence of their rows. What depends on one row
+*   alone, its norm, mass and sum of p log2 p, is computed once when the rows are built, so a pair needs one dot
+*   product or one pass of p + q logs over contiguous floats, written as 'omp simd' reductions. The all-pairs matrix
+*   splits its rows across threads.
+*
+*/
+
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "event.h"
+
+using namespace std;
+
+enum compareMetric{
+    SPEAKER_COSINE,
+    SPEAKER_JS,
+    VOCAB_COSINE,
+    VOCAB_JS,
+    COMPARE_METRIC_COUNT
+};
+
+//what the measures need from one row on its own
+struct rowSummary{
+    float norm = 0.0;       //sqrt(sum x^2)
+    float mass = 0.0;       //sum x
+    float entropy = 0.0;    //sum x log2 x
+};
+
+//every measure for one pair of events
+struct similarity{
+    float speakerCosine = 0.0, speakerJS = 0.0;
+    float vocabCosine = 0.0, vocabJS = 0.0;
+};
+
+
+class eventComparer{
+    public:
+        static const int VOCAB_BUCKETS = 4096;
+
+    private:
+        vector<const event*> sources;
+        size_t speakerCount;
+
+        //events x speakerCount, row major
+        vector<float> words, time, turns, share;
+        //events x VOCAB_BUCKETS, each row sums to 1 unless the event has no words
+        vector<float> vocab;
+
+        //one per row of share and of vocab
+        vector<rowSummary> shareSummaries, vocabSummaries;
+
+        float measure(int, int, int) const;
+
+    public:
+        eventComparer();
+
+        void build(const vector<event*>&);
+        bool isBuilt() const;
+        int indexOf(const event*) const;
+        int getEventCount() const;
+        size_t getSpeakerCount() const;
+
+        const float* getWords(int) const;
+        const float* getTime(int) const;
+        const float* getTurns(int) const;
+        const float* getShare(int) const;
+
+        similarity compare(int, int) const;
+        vector<float> matrix(int, int = 0) const;
+
+        static float cosine(const float*, const float*, size_t);
+        static float jensenShannon(const float*, const float*, size_t);
+
+        static rowSummary summarize(const float*, size_t);
+        static float dot(const float*, const float*, size_t);
+        static float mixtureEntropy(const float*, const float*, size_t);
+        static float cosine(const float*, const float*, size_t, const rowSummary&, const rowSummary&);
+        static float jensenShannon(const float*, const float*, size_t, const rowSummary&, const rowSummary&);
+        static uint32_t hashWord(const char*, size_t);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*!	\file concordance.h
+*	\brief Keyword-in-context index header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: concordance.h\n
+*   \b Purpose: Define a substring index over every script, used for keyword-in-context (KWIC) listings.\n
+*   \n
+*   All scripts are joined into one text, separated so that no match spans two speeches. A suffix array over the
+*   case-folded text is built with SA-IS in linear time, along with its LCP array (Kasai's algorithm). \n
+*   A phrase is found by binary search over the suffix array in O(m log n) for an m character phrase. Every
+*   occurrence then sits in one run of the suffix array, and the run is extended with the LCP array instead of more
+*   string comparisons. Matching ignores ASCII case. \n
+*   The index holds its own copy of every script next to the suffix and LCP arrays, about 9 bytes per character and
+*   13 while building, so callers keep it only while it is in use.
+*
+*/
+
+#ifndef CONCORDANCE_H
+#define CONCORDANCE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include <istream>
+#include "event.h"
+
+using namespace std;
+
+//one occurrence of a phrase with its surrounding text
+struct kwicLine{
+    string speaker;
+    string date;
+    string eventName;
+    int position = 0;
+    string left, match, right;
+};
+
+
+class concordance{
+    private:
+        //a speech's span of the joined text
+        struct document{
+            unsigned int start = 0;
+            int event = 0;
+            int position = 0;
+            int speakerId = -1;
+        };
+
+        string text;                //scripts, each followed by SEPARATOR
+        vector<int> suffixes;       //suffix array over the folded text
+        vector<int> lcp;            //lcp[i] = common prefix of suffixes i - 1 and i
+        vector<document> documents; //ordered by start
+        vector<string> dates, eventNames;
+        bool built;
+        double buildSeconds;
+
+        int compareSuffix(int, const string&) const;
+        int documentAt(int) const;
+
+    public:
+        static const char SEPARATOR = '\1';
+
+        //peak bytes per character of script text while building
+        static const int BUILD_BYTES_PER_CHAR = 13;
+
+        concordance();
+
+        void build(const vector<event*>&);
+        bool isBuilt() const;
+        double getBuildSeconds() const;
+        size_t getLength() const;
+        size_t memoryBytes() const;
+
+        pair<int, int> findRange(const string&) const;
+        int count(const string&) const;
+        vector<kwicLine> search(const string&, int) const;
+        int exportTsv(istream&, ostream&, int) const;
+
+        static void buildSuffixArray(const vector<int>&, vector<int>&, int);
+        static void buildLcp(const vector<int>&, const vector<int>&, vector<int>&);
+};
+
+#endif
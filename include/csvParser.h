@@ -0,0 +1,89 @@
+/*!	\file csvParser.h
+*	\brief CSV parser header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: csvParser.h\n
+*   \b Purpose: Define an RFC 4180 CSV parser and the transcript row reader built on it.\n
+*   \n
+*   The parser is a table-driven state machine that is fed the file in chunks of any size. \n
+*   Quoted fields may contain commas, newlines and escaped "" quotes. Malformed input is recovered where possible
+*   and counted by reason in a csvStats object instead of being reported row by row.
+*
+*/
+
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+//reasons a row was rejected or repaired
+enum csvReason{
+    CSV_FIELD_COUNT,        //rejected: wrong number of fields
+    CSV_BAD_DATE,           //rejected: date is not YYYY-MM-DD
+    CSV_BAD_EVENT,          //rejected: empty event name
+    CSV_BAD_SPEAKER,        //rejected: empty speaker name
+    CSV_BAD_LENGTH,         //rejected: length is not a number
+    CSV_MISSING_LENGTH,     //repaired: empty length read as 0
+    CSV_EMPTY_SCRIPT,       //repaired: empty script kept
+    CSV_STRAY_QUOTE,        //repaired: quote inside an unquoted field kept as text
+    CSV_UNTERMINATED_QUOTE, //repaired: quoted field still open at end of file
+    CSV_REASON_COUNT
+};
+
+struct csvStats{
+    long records = 0;       //records seen, excluding the header
+    long accepted = 0;
+    long rejected = 0;
+    long reasons[CSV_REASON_COUNT] = {};
+
+    static const char* reasonName(int);
+    static bool isRejection(int);
+};
+
+//one line of the transcript CSV
+struct transcriptRow{
+    string date;
+    string eventName;
+    string section;
+    string speaker;
+    string script;
+    float length = 0.0;
+};
+
+
+class csvParser{
+    public:
+        //called with the fields of each record and the file line it started on
+        typedef function<void(const vector<string>&, size_t, long)> recordCallback;
+
+    private:
+        recordCallback onRecord;
+        csvStats* stats;
+
+        int state;
+        vector<string> fields;  //reused between records to keep their capacity
+        size_t fieldCount;
+        long line;
+        long recordLine;
+        bool started;
+
+        void endField();
+        void endRecord();
+
+    public:
+        csvParser(recordCallback, csvStats*);
+
+        void feed(const char*, size_t);
+        void finish();
+};
+
+
+bool parseLength(string_view, float&);
+bool parseTranscriptRow(const vector<string>&, size_t, transcriptRow&, csvStats&);
+
+#endif
@@ -10,19 +10,58 @@
 *   
 */
 
+#ifndef EVENT_H
+#define EVENT_H
+
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
 #include <algorithm>
 #include <forward_list>
+#include <vector>
 #include "speech.h"
+#include "sketch.h"
+#include "roles.h"
 
 using namespace std;
 
+//distribution of turn lengths, in words and seconds
+struct turnDistribution{
+    quantileSketch words, time;
+    logHistogram wordHistogram, timeHistogram;
+
+    void add(int, float);
+    void merge(const turnDistribution&);
+};
+
+//words and time over turns with a plausible rate
+struct paceTotals{
+    int words = 0;
+    float time = 0.0;
+    int turns = 0;
+    int flagged = 0;
+
+    float wordsPerMinute() const;
+    void merge(const paceTotals&);
+};
+
+//totals over the speakers with one role
+struct roleTotals{
+    int speakers = 0, turns = 0, words = 0;
+    float time = 0.0;
+};
+
 struct speakerStats{
-    int timesSpoke = 0, totalWordCount = 0, totalSpeakingTime = 0;
+    int timesSpoke = 0, totalWordCount = 0;
+    float totalSpeakingTime = 0.0;
     int appearances = 0;
+    int speakerId = -1;     //id from aliasResolver::shared()
+    int questions = 0;      //question-shaped turns followed by a different speaker
+    int role = ROLE_UNKNOWN;
+    vector<float> scores;   //lexicon score sums, empty until scored
+    turnDistribution turns;
+    paceTotals pace;
 };
 
 
@@ -35,11 +74,24 @@ class event{
 
         forward_list<speech> speeches;
 
+        //per speech columns, in file order
+        vector<float> lengthColumn;
+        vector<int> wordColumn;
+        vector<int> sectionColumn;
+        vector<string> sections;
+        vector<float> scoreColumn;  //lexicon scores of each speech, scoreCount per speech
+        vector<float> scores;       //event totals per lexicon
+
         int speechCount;
         int totalWordCount;
-        int totalSpeakingTime;
+        float totalSpeakingTime;
         int speakerCount;
 
+        turnDistribution turns;
+
+        roleTotals roles[ROLE_COUNT];
+        bool lastQuestion;      //whether the newest speech is question-shaped
+
     public:
         event();
         event(string, string);
@@ -49,14 +101,31 @@ class event{
         const int getSpeakerCount() const;
         const int getSpeechCount() const;
         const int getWordCount() const;
-        const int getTotalTime() const;
+        const float getTotalTime() const;
+        const vector<string>& getSections() const;
+        const vector<float>& getLengthColumn() const;
+        const vector<int>& getWordColumn() const;
+        const vector<int>& getSectionColumn() const;
+        paceTotals getPace() const;
+        paceTotals getSectionPace(int) const;
+        const turnDistribution& getTurns() const;
+        const roleTotals& getRoleTotals(int) const;
+        int getRoleCount(int) const;
+
+        void assignRoles(const roleModel&);
+        size_t memoryBytes() const;
+
+        void attachScores(vector<float>, int);
+        const vector<float>& getScoreColumn() const;
+        const vector<float>& getScores() const;
 
         void addAttendee(string);
-        map<string, speakerStats> getSpeakers();
+        const map<string, speakerStats>& getSpeakers() const;
+        const forward_list<speech>& getSpeeches() const;
 
         int wordSearch();
 
-        void addSpeech(speech);
+        void addSpeech(speech, string = "");
 
 
         bool operator<(const event& eventObj) const{
@@ -92,39 +161,52 @@ class event{
         }; 
 
 
+        struct sortEventCandidates{ 
+            bool operator()(event* const& e1, event* const& e2){
+                return e1->getRoleCount(ROLE_CANDIDATE) > e2->getRoleCount(ROLE_CANDIDATE); 
+            }
+        }; 
+
+
         //sorting speakers
         struct sortSpeakersName{ 
-            bool operator()( std::pair<std::string, speakerStats> speaker1 , std::pair<std::string, speakerStats> speaker2){
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
                 return speaker1.first < speaker2.first; 
             }
         }; 
 
         struct sortSpeakersAvgWC{ 
-            bool operator()( std::pair<std::string, speakerStats> speaker1 , std::pair<std::string, speakerStats> speaker2){
-                return (speaker1.second.totalWordCount / speaker1.second.timesSpoke)  > (speaker2.second.totalWordCount / speaker2.second.timesSpoke); 
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
+                return ((float)speaker1.second.totalWordCount / speaker1.second.timesSpoke)  > ((float)speaker2.second.totalWordCount / speaker2.second.timesSpoke); 
             }
         }; 
 
         struct sortSpeakersHighWC{ 
-            bool operator()( std::pair<std::string, speakerStats> speaker1 , std::pair<std::string, speakerStats> speaker2){
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
                 return (speaker1.second.totalWordCount)  > (speaker2.second.totalWordCount); 
             }
         }; 
 
         struct sortSpeakersAvgTime{ 
-            bool operator()( std::pair<std::string, speakerStats> speaker1 , std::pair<std::string, speakerStats> speaker2){
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
                 return (speaker1.second.totalSpeakingTime / speaker1.second.timesSpoke)  > (speaker2.second.totalSpeakingTime / speaker2.second.timesSpoke); 
             }
         }; 
 
         struct sortSpeakersHighTime{ 
-            bool operator()( std::pair<std::string, speakerStats> speaker1 , std::pair<std::string, speakerStats> speaker2){
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
                 return (speaker1.second.totalSpeakingTime)  > (speaker2.second.totalSpeakingTime); 
             }
         }; 
 
+        struct sortSpeakersPace{ 
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
+                return speaker1.second.pace.wordsPerMinute() > speaker2.second.pace.wordsPerMinute(); 
+            }
+        }; 
+
         struct sortSpeakersAttendance{ 
-            bool operator()( std::pair<std::string, speakerStats > speaker1 , std::pair<std::string, speakerStats > speaker2){
+            bool operator()(const std::pair<std::string, speakerStats>& speaker1, const std::pair<std::string, speakerStats>& speaker2){
                 return speaker1.second.appearances > speaker2.second.appearances; 
             }
         }; 
@@ -133,4 +215,4 @@ class event{
 
 };
 
-
+#endif
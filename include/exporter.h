@@ -0,0 +1,108 @@
+/*!	\file exporter.h
+*	\brief Columnar export header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: exporter.h\n
+*   \b Purpose: Define the columnar export of events, speaker statistics and speeches.\n
+*   \n
+*   An exportSet holds the data as named tables of typed columns. Speakers, events and sections are dictionary
+*   encoded: the speech and stats tables store int32 codes into the "speakers", "events" and "sections" tables.
+*   Text columns use 64-bit offsets, Arrow's large_utf8, so a script column can pass 2 GiB. \n
+*   The set can be written to a self-contained binary file (see write for the layout), read back, or handed to an
+*   Arrow consumer through the Arrow C Data Interface without copying the column buffers.
+*
+*/
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include "event.h"
+
+using namespace std;
+
+//Arrow C Data Interface, as published at https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif
+
+enum columnType{
+    COL_INT32 = 1,
+    COL_FLOAT32 = 2,
+    COL_UTF8 = 3
+};
+
+struct column{
+    string name;
+    int type = COL_INT32;
+    string dictionary;          //table the int32 codes index into, empty if none
+
+    vector<int32_t> ints;
+    vector<float> floats;
+    vector<int64_t> offsets;    //utf8: rows + 1 offsets into bytes
+    string bytes;
+
+    void addString(const string&);
+    string getString(size_t) const;
+};
+
+struct table{
+    string name;
+    size_t rows = 0;
+    deque<column> columns;     //deque: addColumn never moves existing columns
+
+    column& addColumn(const string&, int, const string& = "");
+    const column* find(const string&) const;
+};
+
+
+class exportSet : public enable_shared_from_this<exportSet>{
+    private:
+        vector<table> tables;
+
+    public:
+        static shared_ptr<exportSet> build(vector<event*>&, bool);
+        static shared_ptr<exportSet> read(const string&);
+
+        bool write(const string&) const;
+        bool exportArrow(const string&, ArrowSchema*, ArrowArray*) const;
+
+        const table* find(const string&) const;
+        const vector<table>& getTables() const;
+};
+
+#endif
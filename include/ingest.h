@@ -0,0 +1,73 @@
+/*!	\file ingest.h
+*	\brief Transcript ingest header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: ingest.h\n
+*   \b Purpose: Read transcript CSV data into event objects.\n
+*   \n
+*   Kept apart from main.cpp so the test programs can link the same ingest path the application uses.
+*
+*/
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <istream>
+#include <vector>
+#include "event.h"
+#include "csvParser.h"
+#include "timeline.h"
+
+using namespace std;
+
+//rows read between budget checks
+const int BUDGET_CHECK_ROWS = 256;
+
+//sampling never keeps fewer rows than 1 in this many
+const int MAX_SAMPLE_STRIDE = 1024;
+
+/*!	\struct ingestBudget
+*   \brief Limits on ingest, and what was given up to stay inside them.
+*
+*   Held bytes are an estimate of the events, their speaker maps and the script store. When they pass maxBytes the
+*   ingest degrades one step at a time, each step taken only if the one before did not hold memory down: \n
+*   - spill sealed script blocks to a temporary file \n
+*   - drop the script text of later rows, keeping their word counts and lengths \n
+*   - keep only 1 in sampleStride of each event's later rows, doubling the stride whenever held bytes grow by another
+*     sixteenth of the budget \n
+*   When maxSeconds passes, reading stops and the events read so far are kept.
+*/
+struct ingestBudget{
+    size_t maxBytes = 0;        //0 for no limit
+    double maxSeconds = 0.0;    //0 for no limit
+
+    size_t peakBytes = 0;
+    size_t limitHitAt = 0;      //held bytes when the memory budget was first reached
+    bool spilled = false;
+    bool dropped = false;
+    int sampleStride = 1;
+    long sampledOut = 0;        //rows skipped by sampling
+    bool timedOut = false;
+    size_t bytesRead = 0;       //input bytes handed to the parser
+
+    bool degraded() const;
+};
+
+/*!
+*   \fn ingestTranscripts
+*	\param istream &in - CSV data, starting with the label line
+*	\param vector<event*> &allSpeeches - Vector to append new events to
+*	\param csvStats &stats - Parse counters to update
+*	\param size_t chunkSize - Number of bytes handed to the parser at a time
+*	\param timeline* seasons - Timeline to add each finished event to, or nullptr
+*	\param ingestBudget* budget - Memory and time limits, updated with what degraded; nullptr for no limits
+*	\return void
+*   
+*   \par Description
+*   Parses the CSV stream and creates an event for each run of rows sharing a date.
+*   Each event's speaker roles are assigned from roleModel::shared() once the event is read.
+*/   
+void ingestTranscripts(istream &in, vector<event*> &allSpeeches, csvStats &stats, size_t chunkSize = 1 << 16, timeline* seasons = nullptr,
+                       ingestBudget* budget = nullptr);
+
+#endif
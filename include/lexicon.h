@@ -0,0 +1,103 @@
+/*!	\file lexicon.h
+*	\brief Lexicon scoring header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: lexicon.h\n
+*   \b Purpose: Define word-list lexicons and the pipeline stage that scores every speech with them.\n
+*   \n
+*   Each lexicon is a text file of "word [weight]" lines; the weight defaults to 1, so a topic list is just words and
+*   a sentiment list gives negative words a negative weight. A speech's score in a lexicon is the sum of the weights of
+*   its words. \n
+*   The words of every lexicon share one perfect hash built with hash-and-displace (CHD): keys are split into buckets,
+*   and each bucket, largest first, gets the smallest displacement that puts all of its keys in free slots. A lookup
+*   is then two hashes and one string compare, whatever the number of lexicons. \n
+*   Scoring runs once after ingest. Speeches are cut into batches that worker threads take from a shared atomic
+*   counter, each thread decompressing script blocks on its own. Scores are cached in a file keyed by a fingerprint
+*   of the lexicons and the events, so later runs only read them back.
+*
+*/
+
+#ifndef LEXICON_H
+#define LEXICON_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include "event.h"
+
+using namespace std;
+
+//speeches handed to a worker at a time
+const int SCORE_BATCH_SPEECHES = 256;
+
+
+class lexiconSet{
+    private:
+        vector<string> names;
+        vector<string> words;       //key index -> word
+        vector<float> weights;      //key index * lexicon count + lexicon
+
+        //perfect hash
+        uint64_t salt;
+        vector<uint32_t> displacements; //per bucket
+        vector<int32_t> slots;          //slot -> key index, or -1
+
+        size_t rejectedLines;           //lines with a malformed weight
+
+        uint64_t hashWord(string_view) const;
+        bool buildHash();
+
+    public:
+        lexiconSet();
+
+        bool add(const string&, istream&);
+        int loadDirectory(const string&);
+        void clear();
+
+        int lookup(string_view) const;
+        const float* getWeights(int) const;
+        void score(string_view, float*) const;
+
+        int getCount() const;
+        const string& getName(int) const;
+        size_t getWordCount() const;
+        size_t getSlotCount() const;
+        size_t getRejectedLines() const;
+        uint64_t fingerprint() const;
+
+        static lexiconSet& shared();
+};
+
+/*!
+*   \fn scoreEvents
+*	\param const vector<event*> &events - Events to score, after ingest has sealed their scripts
+*	\param const lexiconSet &lexicons - Lexicons to score with
+*	\param int threads - Worker threads; 0 for one per hardware thread
+*	\return void
+*
+*   \par Description
+*   Scores every speech and attaches the scores to its event, which rolls them up per speaker and for the event.
+*/
+void scoreEvents(const vector<event*> &events, const lexiconSet &lexicons, int threads = 0);
+
+/*!
+*   \fn writeScoreCache
+*	\param const string &path - File to write
+*	\param const vector<event*> &events - Scored events, in ingest order
+*	\param const lexiconSet &lexicons - Lexicons the events were scored with
+*	\return bool - false if the file could not be written
+*/
+bool writeScoreCache(const string &path, const vector<event*> &events, const lexiconSet &lexicons);
+
+/*!
+*   \fn readScoreCache
+*	\param const string &path - File to read
+*	\param const vector<event*> &events - Events to attach the scores to, in ingest order
+*	\param const lexiconSet &lexicons - Lexicons the scores must come from
+*	\return bool - false, leaving the events unscored, if the file is missing or was written for other lexicons or events
+*/
+bool readScoreCache(const string &path, const vector<event*> &events, const lexiconSet &lexicons);
+
+#endif
@@ -0,0 +1,26 @@
+/*!	\file multiversion.h
+*	\brief Function multiversioning header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: multiversion.h\n
+*   \b Purpose: Define the attribute that compiles a hot kernel once per instruction set.\n
+*   \n
+*   A function marked MULTIVERSION is compiled for baseline x86-64, AVX2 and AVX-512, and the loader picks the
+*   widest version the CPU supports the first time it is called, so one binary runs everywhere and still uses wide
+*   vectors where they exist. Only loops that vectorize gain anything, so the mark belongs on 'omp simd' kernels. \n
+*   Other compilers and targets, or builds with -DNO_MULTIVERSION, get a single version. So do ThreadSanitizer
+*   builds: the loader runs the version resolvers before the TSan runtime is initialised, and they crash.
+*
+*/
+
+#ifndef MULTIVERSION_H
+#define MULTIVERSION_H
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(NO_MULTIVERSION) && \
+    !defined(__SANITIZE_THREAD__)
+#define MULTIVERSION __attribute__((target_clones("default", "avx2", "avx512f")))
+#else
+#define MULTIVERSION
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/*!	\file pager.h
+*	\brief Table pager header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: pager.h\n
+*   \b Purpose: Define a class for printing large tables one screen at a time.\n
+*   \n
+*   A pager holds a table header, a row count and a function that formats one row. \n
+*   Rendering formats only the rows on the current page into a reused buffer and writes the screen in a single call.
+*   The caller passes row numbers in display order, so a sorted table is just a permutation of row indexes.
+*
+*/
+
+#ifndef PAGER_H
+#define PAGER_H
+
+#include <iostream>
+#include <string>
+#include <functional>
+
+using namespace std;
+
+class pager{
+    public:
+        //appends display row i to the buffer
+        typedef function<void(string&, int)> rowFormatter;
+
+    private:
+        ostream* out;
+        string buffer;
+        string header;
+        rowFormatter formatRow;
+        int rowCount;
+        int pageSize;
+        int page;
+
+    public:
+        pager();
+        pager(ostream&, int);
+
+        void setTable(const string&, int, rowFormatter);
+
+        void render();
+        bool nextPage();
+        bool prevPage();
+        bool jumpToRank(int);
+        void browse(istream&);
+
+        int getPage() const;
+        int getPageCount() const;
+        const string& getBuffer() const;
+};
+
+
+//printf into the end of a string; arguments are checked against the format like printf's
+void appendf(string&, const char*, ...) __attribute__((format(printf, 2, 3)));
+
+#endif
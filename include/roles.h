@@ -0,0 +1,62 @@
+/*!	\file roles.h
+*	\brief Speaker role header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: roles.h\n
+*   \b Purpose: Define the roles a speaker can have in an event and how they are assigned.\n
+*   \n
+*   A role comes from the first of these that applies: \n
+*   - the role table, read from a text file of "Name = candidate|moderator|other" lines \n
+*   - the name itself: "Moderator" and "Moderator 2" are moderators; "Audience", "Crowd", "Announcer", "Voiceover",
+*     "Male" and "Female" are other \n
+*   - the speaker's turns: a speaker whose turns are mostly short questions handed straight to another speaker is a
+*     moderator, anyone else is a candidate \n
+*   Roles are assigned once per event, when ingest finishes reading it.
+*
+*/
+
+#ifndef ROLES_H
+#define ROLES_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <istream>
+
+using namespace std;
+
+enum speakerRole{
+    ROLE_UNKNOWN,
+    ROLE_CANDIDATE,
+    ROLE_MODERATOR,
+    ROLE_OTHER,
+    ROLE_COUNT
+};
+
+//a turn is question-shaped if it asks something and is no longer than this
+const int QUESTION_MAX_WORDS = 60;
+
+//share of a speaker's turns that must be questions handed to another speaker for them to count as a moderator
+const float MODERATOR_QUESTION_SHARE = 0.3;
+
+
+class roleModel{
+    private:
+        unordered_map<string, int> table; //normalized name -> role
+
+    public:
+        int load(istream&);
+        int loadFile(const string&);
+        void clear();
+
+        int lookup(const string&) const;
+        int classify(const string&, int, int) const;
+
+        static bool isQuestion(string_view, int);
+        static int parseRole(const string&);
+        static const char* roleName(int);
+
+        static roleModel& shared();
+};
+
+#endif
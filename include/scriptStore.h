@@ -0,0 +1,101 @@
+/*!	\file scriptStore.h
+*	\brief Script storage class header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: scriptStore.h\n
+*   \b Purpose: Define a class for holding speech transcripts in compressed blocks.\n
+*   \n
+*   Script text is appended to an open block while an event is being read. When the event ends the block is sealed,
+*   which compresses it with a small LZ77 codec. Sealed blocks are decompressed on demand into a small LRU cache. \n
+*   Speeches keep a scriptHandle into the store instead of their own copy of the text. \n
+*   To bound memory, sealed blocks can be spilled to a temporary file and read back on a cache miss, and the store
+*   can be told to drop new scripts, handing out empty handles.
+*
+*/
+
+#ifndef SCRIPTSTORE_H
+#define SCRIPTSTORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <cstdio>
+#include <cstdint>
+
+using namespace std;
+
+//location of one script inside the store
+struct scriptHandle{
+    int block = -1;
+    unsigned int offset = 0;
+    unsigned int length = 0;
+};
+
+//instrumentation counters
+struct scriptStoreStats{
+    size_t rawBytes = 0, compressedBytes = 0;
+    size_t cacheHits = 0, cacheMisses = 0;
+    size_t decompressedBytes = 0;
+    double decompressSeconds = 0.0;
+    size_t spilledBytes = 0;    //compressed bytes written to the spill file
+    size_t droppedBytes = 0;    //script bytes discarded while dropping
+};
+
+
+class scriptStore{
+    private:
+        struct block{
+            string compressed;      //empty once spilled
+            unsigned int rawSize = 0;
+            long spillOffset = -1;  //position in the spill file, -1 while in memory
+            size_t compressedSize = 0;
+            uint64_t checksum = 0;  //of the raw text
+        };
+
+        vector<block> blocks;
+        string openBlock;
+
+        size_t cacheCapacity;
+        list<pair<int, string> > cache; //most recently used at front
+
+        scriptStoreStats stats;
+
+        FILE* spillFile;
+        bool spilling;
+        bool dropping;
+
+        const string& fetch(int);
+        bool spillBlock(block&);
+
+    public:
+        scriptStore();
+        scriptStore(size_t);
+        ~scriptStore();
+        scriptStore(const scriptStore&) = delete;
+        scriptStore& operator=(const scriptStore&) = delete;
+
+        scriptHandle add(const string&);
+        void seal();
+        void clear();
+        bool spill();
+        void setDropping(bool);
+        bool isSpilling() const;
+        bool isDropping() const;
+        size_t memoryBytes() const;
+
+        string_view view(scriptHandle);
+        string readBlock(int) const;
+
+        const scriptStoreStats& getStats() const;
+        int getBlockCount() const;
+        uint64_t getChecksum(int) const;
+
+        static scriptStore& shared();
+
+        static string compress(const string&);
+        static string decompress(const string&, size_t);
+        static uint64_t checksum(string_view);
+};
+
+#endif
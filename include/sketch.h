@@ -0,0 +1,77 @@
+/*!	\file sketch.h
+*	\brief Distribution sketch header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: sketch.h\n
+*   \b Purpose: Define fixed-size, mergeable summaries of a stream of values.\n
+*   \n
+*   quantileSketch is a KLL sketch: values are kept in levels, and a full level is sorted and every other value is
+*   promoted to the next level with twice the weight. Memory stays bounded no matter how many values are added,
+*   and two sketches merge by concatenating their levels. Level capacities depend only on k and a level's depth, so
+*   they are computed once per depth, and the sorted weighted items that quantile reads are kept until the next add
+*   or merge. \n
+*   logHistogram counts values in power-of-two buckets.
+*
+*/
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <vector>
+
+using namespace std;
+
+class quantileSketch{
+    private:
+        int k;
+        vector<vector<float> > levels; //items at level i have weight 2^i
+        long count;
+        float minValue, maxValue;
+        bool oddOffset; //alternates which half survives a compaction
+
+        vector<size_t> depthCapacities; //capacity of the level this far below the top
+        size_t totalCapacity;           //of the current levels
+        size_t retained;
+
+        //items in value order with their running weight; rebuilt by quantile after an add or merge
+        mutable vector<float> sortedValues;
+        mutable vector<long> cumulativeWeights;
+        mutable bool sortedValid;
+
+        size_t capacity(size_t) const;
+        void setLevelCount(size_t);
+        void compress();
+
+    public:
+        quantileSketch();
+        quantileSketch(int);
+
+        void add(float);
+        void merge(const quantileSketch&);
+
+        float quantile(double) const;
+        long getCount() const;
+        float getMin() const;
+        float getMax() const;
+        size_t getRetained() const;
+};
+
+
+class logHistogram{
+    public:
+        static const int BUCKETS = 12;
+
+    private:
+        long counts[BUCKETS];
+
+    public:
+        logHistogram();
+
+        void add(float);
+        void merge(const logHistogram&);
+
+        long getBucket(int) const;
+        static float bucketLow(int);
+};
+
+#endif
@@ -1,18 +1,28 @@
+#ifndef SPEECH_H
+#define SPEECH_H
+
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
 #include <algorithm>
 #include <vector>
+#include <string_view>
+#include "scriptStore.h"
+#include "aliases.h"
 
 using namespace std;
 
+//plausible speaking rates, in words per minute
+const float MIN_PACE = 30.0;
+const float MAX_PACE = 400.0;
+
 class speech{
 
 private:
     int position;
-    string speaker;
-    string script;
+    int speakerId;  //id from aliasResolver::shared()
+    scriptHandle script;
     float length;
     int wordCount;
 
@@ -20,15 +30,23 @@ public:
     //constructors
     speech();
     speech(int, string, string, float);
+    speech(int, int, string, float);
 
     //methods
-    int getPosition();
+    int getPosition() const;
     const string getSpeaker() const; 
+    int getSpeakerId() const;
     const string getScript() const; 
-    const int getLength() const; 
+    string_view getScriptView() const;
+    scriptHandle getScriptHandle() const;
+    const float getLength() const; 
     const int getCount() const; 
+    float getPace() const;
+    bool isPaceOutlier() const;
     int countWord(string);
 
+    static bool paceOutlier(int, float);
+
     //operators
     bool operator<(const speech& speechObj) const{
         if (speechObj.position < this->position)
@@ -37,3 +55,4 @@ public:
 
 };
 
+#endif
@@ -0,0 +1,63 @@
+/*!	\file timeline.h
+*	\brief Speaker timeline header file
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: timeline.h\n
+*   \b Purpose: Define a per-speaker time series of event statistics across the season.\n
+*   \n
+*   Each event is added once, when ingest finishes reading it. For every speaker in the event, the timeline appends
+*   one row to that speaker's columns: word count, speaking time, turns, share of the event's speaking time and rank
+*   by speaking time. Speakers are indexed by their interned id from aliasResolver. \n
+*   finish() puts the events in date order and every series with them, so a speaker's trajectory is read straight
+*   from its columns.
+*
+*/
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <string>
+#include <vector>
+#include "event.h"
+
+using namespace std;
+
+//one speaker's rows, one per event they spoke in, in date order after finish()
+struct speakerSeries{
+    vector<int> slot;       //index into the timeline's events
+    vector<int> words;
+    vector<float> time;
+    vector<int> turns;
+    vector<float> share;    //percent of the event's speaking time
+    vector<int> rank;       //1 = most speaking time in the event
+
+    size_t size() const;
+};
+
+
+class timeline{
+    private:
+        vector<string> dates, names;    //per event
+        vector<int> speakerCounts;      //per event
+        vector<speakerSeries> series;   //per speaker id
+        bool sorted;
+
+    public:
+        timeline();
+
+        void addEvent(const event&);
+        void finish();
+        void clear();
+
+        int getEventCount() const;
+        const string& getDate(int) const;
+        const string& getName(int) const;
+        int getSpeakerCount(int) const;
+
+        const speakerSeries* getSeries(int) const;
+        float trend(int) const;
+        float delta(int, size_t) const;
+        vector<int> rankHistory(int) const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#!/bin/sh
+# Training run for the profile-guided build (make pgo). Drives the instrumented binary over the bundled CSV:
+# the ingest benchmark first, then a walk through the menus covering the sorts, event details, comparisons,
+# speaker tables and phrase search. Run from the repository root, where the data files are.
+#
+# Usage: sh scripts/pgo_train.sh [binary]
+
+set -e
+BIN=${1:-bin/pgo/main}
+BIN=$(cd "$(dirname "$BIN")" && pwd)/$(basename "$BIN")
+
+# run in a scratch copy of the data files, so the score cache and exports never touch the working tree.
+# the profile is still written next to the objects, whose paths were fixed when they were compiled
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+cp debate_transcripts_v3_2020-02-26.csv speaker_aliases.txt speaker_roles.txt "$WORK"
+cp -r lexicons "$WORK"
+cd "$WORK"
+
+# parsing, alias resolution, roles and script compression
+"$BIN" --bench-ingest 5
+
+# the copy has no score cache, so this run also scores every speech.
+# every menu leaves at end of input, so a walk that falls out of step still finishes
+"$BIN" > /dev/null <<'EOF'
+A
+A
+B
+C
+F
+E
+D
+1 2 3
+X
+1
+A
+X
+B
+X
+C
+X
+D
+X
+E
+X
+F
+X
+G
+N
+X
+H
+R
+M
+X
+X
+B
+A
+N
+X
+B
+X
+C
+X
+D
+X
+E
+X
+F
+X
+G
+X
+H
+X
+R
+M
+X
+1
+X
+I
+C
+E
+A
+health care
+X
+A
+climate
+X
+X
+X
+X
+X
+X
+X
+EOF
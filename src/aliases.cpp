@@ -0,0 +1,393 @@
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cctype>
+#include "aliases.h"
+
+using namespace std;
+
+//leading titles dropped from a name when something follows them
+static const char* HONORIFICS[] = {
+    "vice president", "secretary", "sec.", "senator", "sen.", "governor", "gov.", "mayor",
+    "representative", "rep.", "congressman", "congresswoman", "mr.", "mrs.", "ms.", "dr."
+};
+
+/************************************************************/
+// Function name: shared
+// Description: returns the resolver used by the application's ingest path
+// Parameters: none
+// Return Value: aliasResolver& - shared resolver
+/************************************************************/
+aliasResolver& aliasResolver::shared(){
+    static aliasResolver resolver;
+    return resolver;
+}
+
+/************************************************************/
+// Function name: tidy
+// Description: Trims a name, collapses runs of whitespace to one space and drops a leading honorific.
+// Parameters: string_view raw - name as read
+// Return Value: string - tidied name, case preserved
+/************************************************************/
+string aliasResolver::tidy(string_view raw){
+    string name;
+    name.reserve(raw.size());
+    for (char c : raw){
+        if (isspace((unsigned char)c)){
+            if (!name.empty() && name.back() != ' ')
+                name.push_back(' ');
+        }
+        else{
+            name.push_back(c);
+        }
+    }
+    if (!name.empty() && name.back() == ' ')
+        name.pop_back();
+
+    for (const char* title : HONORIFICS){
+        size_t length = char_traits<char>::length(title);
+        if (name.size() > length + 1 && name[length] == ' '){
+            bool match = true;
+            for (size_t i = 0; i < length && match; i++)
+                match = tolower((unsigned char)name[i]) == title[i];
+            if (match)
+                return name.substr(length + 1);
+        }
+    }
+
+    return name;
+}
+
+/************************************************************/
+// Function name: normalize
+// Description: returns the lookup key for a name: tidied and lowercased
+// Parameters: string_view raw - name as read
+// Return Value: string - normalized key
+/************************************************************/
+string aliasResolver::normalize(string_view raw){
+    string key = tidy(raw);
+    for (char& c : key)
+        c = tolower((unsigned char)c);
+    return key;
+}
+
+/************************************************************/
+// Function name: load
+// Description: Reads alias lines of the form "variant = Canonical Name". Blank lines and lines starting with # are
+//              skipped. A canonical name also becomes an alias of itself, so its case variants resolve to it.
+// Parameters: istream &in - alias table text
+// Return Value: int - number of aliases read
+/************************************************************/
+int aliasResolver::load(istream &in){
+    string line;
+    int count = 0;
+
+    while (getline(in, line)){
+        size_t equals = line.find('=');
+        string variant = tidy(string_view(line).substr(0, equals));
+        if (variant.empty() || variant[0] == '#' || equals == string::npos)
+            continue;
+
+        string canonical = tidy(string_view(line).substr(equals + 1));
+        if (canonical.empty())
+            continue;
+
+        aliases[normalize(variant)] = canonical;
+        aliases[normalize(canonical)] = canonical;
+        count++;
+    }
+
+    //cached names may resolve differently now
+    rawCache.clear();
+    return count;
+}
+
+/************************************************************/
+// Function name: loadFile
+// Description: Reads an alias table file.
+// Parameters: const string& path - file to read
+// Return Value: int - number of aliases read, -1 if the file could not be opened
+/************************************************************/
+int aliasResolver::loadFile(const string& path){
+    ifstream in(path);
+    if (!in.is_open())
+        return -1;
+    return load(in);
+}
+
+/************************************************************/
+// Function name: clear
+// Description: Forgets every alias and interned name.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void aliasResolver::clear(){
+    aliases.clear();
+    rawCache.clear();
+    ids.clear();
+    names.clear();
+    uses.clear();
+}
+
+/************************************************************/
+// Function name: intern
+// Description: returns the id of a canonical name, adding it on first use
+// Parameters: const string& canonical - canonical spelling
+// Return Value: int - id
+/************************************************************/
+int aliasResolver::intern(const string& canonical){
+    string key = normalize(canonical);
+    auto found = ids.find(key);
+    if (found != ids.end())
+        return found->second;
+
+    int id = names.size();
+    ids.emplace(key, id);
+    names.push_back(canonical);
+    uses.push_back(0);
+    return id;
+}
+
+/************************************************************/
+// Function name: resolve
+// Description: Maps a raw speaker name to its canonical id.
+// Parameters: const string& raw - name as read
+// Return Value: int - id
+/************************************************************/
+int aliasResolver::resolve(const string& raw){
+    auto cached = rawCache.find(raw);
+    if (cached != rawCache.end())
+        return cached->second;
+
+    auto alias = aliases.find(normalize(raw));
+    int id = intern(alias != aliases.end() ? alias->second : tidy(raw));
+
+    rawCache.emplace(raw, id);
+    return id;
+}
+
+/************************************************************/
+// Function name: countUse
+// Description: Counts one speech under a name. Only ingest counts, so lookups made elsewhere do not change the
+//              order of suggestions.
+// Parameters: int id - id from resolve
+// Return Value: none
+/************************************************************/
+void aliasResolver::countUse(int id){
+    if (id >= 0 && id < (int)uses.size())
+        uses[id]++;
+}
+
+/************************************************************/
+// Function name: getName
+// Description: returns the canonical spelling of an id
+// Parameters: int id - id from resolve
+// Return Value: const string& - name, empty for an unknown id
+/************************************************************/
+const string& aliasResolver::getName(int id) const{
+    static const string none;
+    if (id < 0 || id >= (int)names.size())
+        return none;
+    return names[id];
+}
+
+/************************************************************/
+// Function name: getCount
+// Description: returns number of interned names
+// Parameters: none
+// Return Value: int - name count
+/************************************************************/
+int aliasResolver::getCount() const {return names.size();}
+
+/************************************************************/
+// Function name: getUses
+// Description: returns how many speeches ingest has counted under an id
+// Parameters: int id - id from resolve
+// Return Value: long - use count
+/************************************************************/
+long aliasResolver::getUses(int id) const{
+    if (id < 0 || id >= (int)uses.size())
+        return 0;
+    return uses[id];
+}
+
+/************************************************************/
+// Function name: getAliasCount
+// Description: returns number of alias table entries, canonical self-entries included
+// Parameters: none
+// Return Value: size_t - alias count
+/************************************************************/
+size_t aliasResolver::getAliasCount() const {return aliases.size();}
+
+/************************************************************/
+// Function name: editDistance
+// Description: Levenshtein distance, giving up once it must exceed a bound.
+// Parameters: const string& a, const string& b - strings to compare
+//             int bound - largest distance of interest
+// Return Value: int - distance, or bound + 1 if it is larger than bound
+/************************************************************/
+int aliasResolver::editDistance(const string& a, const string& b, int bound){
+    int n = a.size(), m = b.size();
+    if (abs(n - m) > bound)
+        return bound + 1;
+
+    vector<int> row(m + 1);
+    for (int j = 0; j <= m; j++)
+        row[j] = j;
+
+    for (int i = 1; i <= n; i++){
+        int diagonal = row[0];
+        row[0] = i;
+        int best = row[0];
+        for (int j = 1; j <= m; j++){
+            int above = row[j];
+            row[j] = min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+            best = min(best, row[j]);
+        }
+        if (best > bound)
+            return bound + 1;
+    }
+
+    return min(row[m], bound + 1);
+}
+
+//splits a normalized name on spaces
+static vector<string> tokens(const string& key){
+    vector<string> parts;
+    size_t start = 0;
+    while (start <= key.size()){
+        size_t space = key.find(' ', start);
+        if (space == string::npos)
+            space = key.size();
+        if (space > start)
+            parts.push_back(key.substr(start, space - start));
+        start = space + 1;
+    }
+    return parts;
+}
+
+//true if one token is the other's initial, e.g. "j." and "john"
+static bool isInitial(const string& a, const string& b){
+    if (a.size() > 3 || a.back() != '.' || a.size() - 1 > b.size())
+        return false;
+    return b.compare(0, a.size() - 1, a, 0, a.size() - 1) == 0 && b.size() > a.size() - 1;
+}
+
+//true if every token of the shorter name matches a later token of the longer one: equal, an initial, or a typo
+//(one edit per five letters) apart
+static bool tokensMatch(const string& a, const string& b){
+    vector<string> shorter = tokens(a), longer = tokens(b);
+    if (shorter.size() > longer.size())
+        swap(shorter, longer);
+    if (shorter.empty())
+        return false;
+
+    bool fullToken = false;
+    size_t next = 0;
+    for (auto& token : shorter){
+        bool found = false;
+        while (next < longer.size() && !found){
+            const string& other = longer[next++];
+            int typos = min(token.size(), other.size()) / 5;
+            if (token == other || (typos > 0 && aliasResolver::editDistance(token, other, typos) <= typos)){
+                found = true;
+                fullToken = fullToken || token.size() >= 3;
+            }
+            else if (isInitial(token, other) || isInitial(other, token)){
+                found = true;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return fullToken;
+}
+
+//digits in a name, which must agree: "speaker 1" is not "speaker 12"
+static string digits(const string& key){
+    string found;
+    for (char c : key){
+        if (isdigit((unsigned char)c))
+            found.push_back(c);
+    }
+    return found;
+}
+
+/************************************************************/
+// Function name: suggest
+// Description: Finds pairs of interned names that are probably the same person. Candidates share at least a third of
+//              their trigrams; a pair is kept if its edit distance is within the bound (scaled down for short names)
+//              or its words match up with initials or single typos, e.g. "J. Hickenlooper" and "John Hickenlooper".
+// Parameters: int maxDistance - largest edit distance to accept
+// Return Value: vector<aliasSuggestion> - suggestions, most used variants first
+/************************************************************/
+vector<aliasSuggestion> aliasResolver::suggest(int maxDistance) const{
+    vector<string> keys(names.size());
+    vector<int> trigramCount(names.size(), 0);
+    unordered_map<string, vector<int> > index;
+
+    //index each name's distinct trigrams, padded so word edges count
+    for (size_t id = 0; id < names.size(); id++){
+        if (uses[id] == 0)
+            continue;
+        keys[id] = normalize(names[id]);
+        string padded = "  " + keys[id] + " ";
+        vector<string> grams;
+        for (size_t i = 0; i + 3 <= padded.size(); i++)
+            grams.push_back(padded.substr(i, 3));
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+
+        trigramCount[id] = grams.size();
+        for (auto& gram : grams)
+            index[gram].push_back(id);
+    }
+
+    //count shared trigrams for each pair that has any
+    vector<unordered_map<int, int> > shared(names.size());
+    for (auto& posting : index){
+        const vector<int>& list = posting.second;
+        for (size_t i = 0; i < list.size(); i++){
+            for (size_t j = i + 1; j < list.size(); j++)
+                shared[list[i]][list[j]]++;
+        }
+    }
+
+    vector<aliasSuggestion> suggestions;
+    for (size_t a = 0; a < names.size(); a++){
+        for (auto& pair : shared[a]){
+            int b = pair.first;
+            if (3 * pair.second < min(trigramCount[a], trigramCount[b]))
+                continue;
+            if (digits(keys[a]) != digits(keys[b]))
+                continue;
+
+            int bound = min(maxDistance, (int)min(keys[a].size(), keys[b].size()) / 5);
+            int distance = editDistance(keys[a], keys[b], bound);
+            if (distance > bound){
+                if (!tokensMatch(keys[a], keys[b]))
+                    continue;
+                distance = -1;
+            }
+
+            aliasSuggestion suggestion;
+            bool aMore = uses[a] > uses[b] || (uses[a] == uses[b] && (int)a < b);
+            suggestion.variant = aMore ? b : a;
+            suggestion.canonical = aMore ? a : b;
+            suggestion.distance = distance;
+            suggestions.push_back(suggestion);
+        }
+    }
+
+    sort(suggestions.begin(), suggestions.end(), [&](const aliasSuggestion& x, const aliasSuggestion& y){
+        if (uses[x.variant] != uses[y.variant])
+            return uses[x.variant] > uses[y.variant];
+        return names[x.variant] < names[y.variant];
+    });
+    return suggestions;
+}
@@ -0,0 +1,340 @@
+
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include "compare.h"
+#include "multiversion.h"
+
+using namespace std;
+
+//constructor
+eventComparer::eventComparer(){
+    speakerCount = 0;
+}
+
+/************************************************************/
+// Function name: hashWord
+// Description: FNV-1a hash of a word
+// Parameters: const char* word - word characters, already lowercased
+//             size_t length - number of characters
+// Return Value: uint32_t - hash
+/************************************************************/
+uint32_t eventComparer::hashWord(const char* word, size_t length){
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++){
+        hash ^= (unsigned char)word[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/************************************************************/
+// Function name: build
+// Description: Fills the speaker and vocabulary rows of every event.
+// Parameters: const vector<event*>& allSpeeches - events to compare
+// Return Value: none
+/************************************************************/
+void eventComparer::build(const vector<event*>& allSpeeches){
+    sources.assign(allSpeeches.begin(), allSpeeches.end());
+    speakerCount = aliasResolver::shared().getCount();
+
+    size_t rows = sources.size();
+    words.assign(rows * speakerCount, 0.0);
+    time.assign(rows * speakerCount, 0.0);
+    turns.assign(rows * speakerCount, 0.0);
+    share.assign(rows * speakerCount, 0.0);
+    vocab.assign(rows * VOCAB_BUCKETS, 0.0);
+
+    string word;
+    for (size_t e = 0; e < rows; e++){
+        const event* ev = sources[e];
+
+        //share of speaking time, or of words for an event without lengths
+        bool byTime = ev->getTotalTime() > 0;
+        float total = byTime ? ev->getTotalTime() : ev->getWordCount();
+
+        for (auto& speaker : ev->getSpeakers()){
+            int id = speaker.second.speakerId;
+            if (id < 0 || (size_t)id >= speakerCount)
+                continue;
+            size_t cell = e * speakerCount + id;
+            words[cell] = speaker.second.totalWordCount;
+            time[cell] = speaker.second.totalSpeakingTime;
+            turns[cell] = speaker.second.timesSpoke;
+            share[cell] = total > 0 ? (byTime ? speaker.second.totalSpeakingTime : speaker.second.totalWordCount) / total : 0.0;
+        }
+
+        //word frequencies: lowercase runs of letters and digits
+        float* counts = &vocab[e * VOCAB_BUCKETS];
+        long wordCount = 0;
+        for (auto& sp : ev->getSpeeches()){
+            string_view script = sp.getScriptView();
+            for (size_t i = 0; i <= script.size(); i++){
+                if (i < script.size() && isalnum((unsigned char)script[i])){
+                    word.push_back(tolower((unsigned char)script[i]));
+                }
+                else if (!word.empty()){
+                    counts[hashWord(word.data(), word.size()) & (VOCAB_BUCKETS - 1)] += 1.0;
+                    wordCount++;
+                    word.clear();
+                }
+            }
+        }
+        if (wordCount > 0){
+            for (int b = 0; b < VOCAB_BUCKETS; b++)
+                counts[b] /= wordCount;
+        }
+    }
+
+    shareSummaries.resize(rows);
+    vocabSummaries.resize(rows);
+    for (size_t e = 0; e < rows; e++){
+        shareSummaries[e] = summarize(getShare(e), speakerCount);
+        vocabSummaries[e] = summarize(&vocab[e * VOCAB_BUCKETS], VOCAB_BUCKETS);
+    }
+}
+
+/************************************************************/
+// Function name: isBuilt
+// Description: returns whether build has run
+// Parameters: none
+// Return Value: bool - true once built
+/************************************************************/
+bool eventComparer::isBuilt() const {return !sources.empty();}
+
+/************************************************************/
+// Function name: indexOf
+// Description: returns the row of an event
+// Parameters: const event* eventObj - event passed to build
+// Return Value: int - row, -1 if the event was not built
+/************************************************************/
+int eventComparer::indexOf(const event* eventObj) const{
+    auto found = find(sources.begin(), sources.end(), eventObj);
+    return found == sources.end() ? -1 : found - sources.begin();
+}
+
+/************************************************************/
+// Function name: getEventCount
+// Description: returns number of rows
+// Parameters: none
+// Return Value: int - event count
+/************************************************************/
+int eventComparer::getEventCount() const {return sources.size();}
+
+/************************************************************/
+// Function name: getSpeakerCount
+// Description: returns number of speaker columns
+// Parameters: none
+// Return Value: size_t - columns, one per interned speaker id
+/************************************************************/
+size_t eventComparer::getSpeakerCount() const {return speakerCount;}
+
+/************************************************************/
+// Function name: getWords / getTime / getTurns / getShare
+// Description: return an event's row of a speaker matrix, indexed by speaker id. Share is a fraction of the
+//              event's speaking time.
+// Parameters: int row - event row
+// Return Value: const float* - speakerCount values
+/************************************************************/
+const float* eventComparer::getWords(int row) const {return &words[row * speakerCount];}
+const float* eventComparer::getTime(int row) const {return &time[row * speakerCount];}
+const float* eventComparer::getTurns(int row) const {return &turns[row * speakerCount];}
+const float* eventComparer::getShare(int row) const {return &share[row * speakerCount];}
+
+//log2 for positive normal floats, within 3e-5: exponent bits plus a polynomial in the mantissa; vectorizes
+static inline float fastLog2(float x){
+    uint32_t bits = __builtin_bit_cast(uint32_t, x);
+    float exponent = (float)((int)(bits >> 23) - 127);
+    float mantissa = __builtin_bit_cast(float, (bits & 0x007FFFFF) | 0x3F800000);
+
+    float t = mantissa - 1.0f;
+    return exponent + t * (1.4418255f + t * (-0.7086789f + t * (0.4154112f + t * (-0.1944083f + t * 0.0458790f))));
+}
+
+//added inside every log so zero entries need no branch and still contribute nothing
+static const float LOG_FLOOR = 1e-30f;
+
+/************************************************************/
+// Function name: summarize
+// Description: Computes the parts of both measures that depend on one vector alone.
+// Parameters: const float* x - vector
+//             size_t n - length
+// Return Value: rowSummary - norm, mass and sum of x log2 x
+/************************************************************/
+MULTIVERSION
+rowSummary eventComparer::summarize(const float* x, size_t n){
+    float squares = 0.0, mass = 0.0, entropy = 0.0;
+
+    #pragma omp simd reduction(+:squares, mass, entropy)
+    for (size_t i = 0; i < n; i++){
+        squares += x[i] * x[i];
+        mass += x[i];
+        entropy += x[i] * fastLog2(x[i] + LOG_FLOOR);
+    }
+
+    rowSummary summary;
+    summary.norm = sqrt(squares);
+    summary.mass = mass;
+    summary.entropy = entropy;
+    return summary;
+}
+
+/************************************************************/
+// Function name: dot
+// Description: Dot product of two vectors.
+// Parameters: const float* a, const float* b - vectors
+//             size_t n - length
+// Return Value: float - dot product
+/************************************************************/
+MULTIVERSION
+float eventComparer::dot(const float* a, const float* b, size_t n){
+    float sum = 0.0;
+
+    #pragma omp simd reduction(+:sum)
+    for (size_t i = 0; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+/************************************************************/
+// Function name: mixtureEntropy
+// Description: The only part of the Jensen-Shannon divergence that depends on both distributions:
+//              sum( (p + q) log2(p + q) )
+// Parameters: const float* p, const float* q - distributions
+//             size_t n - length
+// Return Value: float - sum
+/************************************************************/
+MULTIVERSION
+float eventComparer::mixtureEntropy(const float* p, const float* q, size_t n){
+    float sum = 0.0;
+
+    #pragma omp simd reduction(+:sum)
+    for (size_t i = 0; i < n; i++){
+        float m = p[i] + q[i];
+        sum += m * fastLog2(m + LOG_FLOOR);
+    }
+    return sum;
+}
+
+/************************************************************/
+// Function name: cosine
+// Description: Cosine similarity of two vectors whose norms are already known, or of two vectors alone.
+// Parameters: const float* a, const float* b - vectors
+//             size_t n - length
+//             const rowSummary &summaryA, &summaryB - summaries of a and b
+// Return Value: float - similarity, 0 if either vector is all zeros
+/************************************************************/
+float eventComparer::cosine(const float* a, const float* b, size_t n, const rowSummary &summaryA, const rowSummary &summaryB){
+    if (summaryA.norm <= 0 || summaryB.norm <= 0)
+        return 0.0;
+    return dot(a, b, n) / (summaryA.norm * summaryB.norm);
+}
+
+float eventComparer::cosine(const float* a, const float* b, size_t n){
+    return cosine(a, b, n, summarize(a, n), summarize(b, n));
+}
+
+/************************************************************/
+// Function name: jensenShannon
+// Description: Jensen-Shannon divergence, in bits, of two distributions whose summaries are already known, or of
+//              two distributions alone:
+//              JS = 1/2 sum( p log2(2p / (p + q)) + q log2(2q / (p + q)) )
+//                 = 1/2 ( sum p + sum q + sum p log2 p + sum q log2 q - sum (p + q) log2(p + q) )
+//              so a pair only takes one log per entry.
+// Parameters: const float* p, const float* q - distributions, each summing to 1 or all zeros
+//             size_t n - length
+//             const rowSummary &summaryP, &summaryQ - summaries of p and q
+// Return Value: float - divergence between 0 (identical) and 1 (disjoint); 1 if only one vector is all zeros
+/************************************************************/
+float eventComparer::jensenShannon(const float* p, const float* q, size_t n, const rowSummary &summaryP, const rowSummary &summaryQ){
+    if (summaryP.mass <= 0 && summaryQ.mass <= 0)
+        return 0.0;
+    if (summaryP.mass <= 0 || summaryQ.mass <= 0)
+        return 1.0;
+
+    float sum = summaryP.mass + summaryQ.mass + summaryP.entropy + summaryQ.entropy - mixtureEntropy(p, q, n);
+    return min(1.0f, max(0.0f, 0.5f * sum));
+}
+
+float eventComparer::jensenShannon(const float* p, const float* q, size_t n){
+    return jensenShannon(p, q, n, summarize(p, n), summarize(q, n));
+}
+
+/************************************************************/
+// Function name: measure
+// Description: returns one metric for a pair of rows
+// Parameters: int a, int b - event rows
+//             int metric - compareMetric
+// Return Value: float - metric value
+/************************************************************/
+float eventComparer::measure(int a, int b, int metric) const{
+    switch (metric){
+        case SPEAKER_COSINE:
+            return cosine(getShare(a), getShare(b), speakerCount, shareSummaries[a], shareSummaries[b]);
+        case SPEAKER_JS:
+            return jensenShannon(getShare(a), getShare(b), speakerCount, shareSummaries[a], shareSummaries[b]);
+        case VOCAB_COSINE:
+            return cosine(&vocab[a * VOCAB_BUCKETS], &vocab[b * VOCAB_BUCKETS], VOCAB_BUCKETS, vocabSummaries[a], vocabSummaries[b]);
+        case VOCAB_JS:
+            return jensenShannon(&vocab[a * VOCAB_BUCKETS], &vocab[b * VOCAB_BUCKETS], VOCAB_BUCKETS, vocabSummaries[a], vocabSummaries[b]);
+        default:
+            return 0.0;
+    }
+}
+
+/************************************************************/
+// Function name: compare
+// Description: returns every metric for a pair of events
+// Parameters: int a, int b - event rows
+// Return Value: similarity - metrics
+/************************************************************/
+similarity eventComparer::compare(int a, int b) const{
+    similarity result;
+    result.speakerCosine = measure(a, b, SPEAKER_COSINE);
+    result.speakerJS = measure(a, b, SPEAKER_JS);
+    result.vocabCosine = measure(a, b, VOCAB_COSINE);
+    result.vocabJS = measure(a, b, VOCAB_JS);
+    return result;
+}
+
+/************************************************************/
+// Function name: matrix
+// Description: Computes one metric for every pair of events. Both metrics are symmetric, so only the upper triangle
+//              is computed. Threads take rows from a shared counter, since later rows have fewer pairs.
+// Parameters: int metric - compareMetric
+//             int threads - worker threads; 0 for one per hardware thread
+// Return Value: vector<float> - events x events, row major
+/************************************************************/
+vector<float> eventComparer::matrix(int metric, int threads) const{
+    int n = sources.size();
+    vector<float> result((size_t)n * n, 0.0);
+
+    //each pair is written by the thread that took its upper row
+    atomic<int> next(0);
+    auto work = [&](){
+        for (int a = next++; a < n; a = next++){
+            result[(size_t)a * n + a] = measure(a, a, metric);
+            for (int b = a + 1; b < n; b++){
+                result[(size_t)a * n + b] = measure(a, b, metric);
+                result[(size_t)b * n + a] = result[(size_t)a * n + b];
+            }
+        }
+    };
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    threads = max(1, min(threads, n));
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(work);
+    work();
+    for (auto& worker : pool)
+        worker.join();
+
+    return result;
+}
@@ -0,0 +1,441 @@
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include "concordance.h"
+
+using namespace std;
+
+//ASCII case folding used for both the index and the query
+static inline unsigned char fold(char c){
+    return tolower((unsigned char)c);
+}
+
+//constructor
+concordance::concordance(){
+    text = "";
+    built = false;
+    buildSeconds = 0.0;
+}
+
+/************************************************************/
+// SA-IS (Nong, Zhang and Chan): suffixes are classed S or L by comparing each with its right neighbour. The
+// leftmost-S (LMS) suffixes are sorted first; inducing from them sorts the rest. When LMS substrings are not all
+// distinct, they are named and sorted recursively.
+/************************************************************/
+
+//fills bkt with the start (or end) of each character's bucket
+static void getBuckets(const int* s, int n, int K, vector<int>& bkt, bool end){
+    fill(bkt.begin(), bkt.end(), 0);
+    for (int i = 0; i < n; i++)
+        bkt[s[i]]++;
+    int sum = 0;
+    for (int c = 0; c < K; c++){
+        sum += bkt[c];
+        bkt[c] = end ? sum : sum - bkt[c];
+    }
+}
+
+//sorts L suffixes left to right, then S suffixes right to left, from the LMS suffixes already in place
+static void induce(const int* s, int* sa, int n, int K, const vector<char>& t, vector<int>& bkt){
+    getBuckets(s, n, K, bkt, false);
+    for (int i = 0; i < n; i++){
+        int j = sa[i] - 1;
+        if (sa[i] > 0 && !t[j])
+            sa[bkt[s[j]]++] = j;
+    }
+    getBuckets(s, n, K, bkt, true);
+    for (int i = n - 1; i >= 0; i--){
+        int j = sa[i] - 1;
+        if (sa[i] > 0 && t[j])
+            sa[--bkt[s[j]]] = j;
+    }
+}
+
+//s[n - 1] must be 0 and occur nowhere else; every value must be below K
+static void sais(const int* s, int* sa, int n, int K){
+    vector<char> t(n, false); //true for S suffixes
+    t[n - 1] = true;
+    for (int i = n - 2; i >= 0; i--)
+        t[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && t[i + 1]);
+    auto isLMS = [&](int i){ return i > 0 && t[i] && !t[i - 1]; };
+
+    //place LMS suffixes at the ends of their buckets and induce
+    vector<int> bkt(K);
+    getBuckets(s, n, K, bkt, true);
+    fill(sa, sa + n, -1);
+    for (int i = 1; i < n; i++){
+        if (isLMS(i))
+            sa[--bkt[s[i]]] = i;
+    }
+    induce(s, sa, n, K, t, bkt);
+
+    //collect the now sorted LMS substrings at the front
+    int n1 = 0;
+    for (int i = 0; i < n; i++){
+        if (isLMS(sa[i]))
+            sa[n1++] = sa[i];
+    }
+
+    //name them; equal substrings share a name
+    fill(sa + n1, sa + n, -1);
+    int name = 0, prev = -1;
+    for (int i = 0; i < n1; i++){
+        int pos = sa[i];
+        bool diff = false;
+        for (int d = 0; ; d++){
+            if (prev == -1 || s[pos + d] != s[prev + d] || t[pos + d] != t[prev + d]){
+                diff = true;
+                break;
+            }
+            else if (d > 0 && (isLMS(pos + d) || isLMS(prev + d))){
+                break;
+            }
+        }
+        if (diff){
+            name++;
+            prev = pos;
+        }
+        sa[n1 + pos / 2] = name - 1; //LMS positions are at least two apart
+    }
+    for (int i = n - 1, j = n - 1; i >= n1; i--){
+        if (sa[i] >= 0)
+            sa[j--] = sa[i];
+    }
+
+    //sort the reduced string, recursing if names repeat
+    int* s1 = sa + n - n1;
+    int* sa1 = sa;
+    if (name < n1){
+        sais(s1, sa1, n1, name);
+    }
+    else{
+        for (int i = 0; i < n1; i++)
+            sa1[s1[i]] = i;
+    }
+
+    //place the LMS suffixes in their final order and induce the rest
+    getBuckets(s, n, K, bkt, true);
+    for (int i = 1, j = 0; i < n; i++){
+        if (isLMS(i))
+            s1[j++] = i;
+    }
+    for (int i = 0; i < n1; i++)
+        sa1[i] = s1[sa1[i]];
+    fill(sa + n1, sa + n, -1);
+    for (int i = n1 - 1; i >= 0; i--){
+        int j = sa[i];
+        sa[i] = -1;
+        sa[--bkt[s[j]]] = j;
+    }
+    induce(s, sa, n, K, t, bkt);
+}
+
+/************************************************************/
+// Function name: buildSuffixArray
+// Description: Builds the suffix array of an integer string with SA-IS.
+// Parameters: const vector<int>& s - string, ending with a 0 that appears nowhere else
+//             vector<int>& sa - filled with suffix start positions in sorted order
+//             int K - alphabet size; every value in s is below K
+// Return Value: none
+/************************************************************/
+void concordance::buildSuffixArray(const vector<int>& s, vector<int>& sa, int K){
+    sa.assign(s.size(), 0);
+    if (s.size() > 1)
+        sais(s.data(), sa.data(), s.size(), K);
+}
+
+/************************************************************/
+// Function name: buildLcp
+// Description: Builds the LCP array with Kasai's algorithm in linear time.
+// Parameters: const vector<int>& s - string the suffix array was built on
+//             const vector<int>& sa - suffix array
+//             vector<int>& lcp - filled with lcp[i] = common prefix length of suffixes sa[i - 1] and sa[i], lcp[0] = 0
+// Return Value: none
+/************************************************************/
+void concordance::buildLcp(const vector<int>& s, const vector<int>& sa, vector<int>& lcp){
+    int n = s.size();
+    vector<int> rank(n);
+    for (int i = 0; i < n; i++)
+        rank[sa[i]] = i;
+
+    lcp.assign(n, 0);
+    int h = 0;
+    for (int i = 0; i < n; i++){
+        if (rank[i] > 0){
+            int j = sa[rank[i] - 1];
+            while (i + h < n && j + h < n && s[i + h] == s[j + h])
+                h++;
+            lcp[rank[i]] = h;
+            if (h > 0)
+                h--;
+        }
+        else{
+            h = 0;
+        }
+    }
+}
+
+/************************************************************/
+// Function name: build
+// Description: Joins every script and indexes the result.
+// Parameters: const vector<event*>& allSpeeches - events to index
+// Return Value: none
+/************************************************************/
+void concordance::build(const vector<event*>& allSpeeches){
+    auto start = chrono::steady_clock::now();
+
+    text.clear();
+    documents.clear();
+    dates.clear();
+    eventNames.clear();
+
+    for (size_t e = 0; e < allSpeeches.size(); e++){
+        dates.push_back(allSpeeches[e]->getDate());
+        eventNames.push_back(allSpeeches[e]->getName());
+
+        //speech list is newest first; index in file order
+        vector<const speech*> ordered;
+        for (auto& sp : allSpeeches[e]->getSpeeches())
+            ordered.push_back(&sp);
+
+        for (auto sp = ordered.rbegin(); sp != ordered.rend(); sp++){
+            document doc;
+            doc.start = text.size();
+            doc.event = e;
+            doc.position = (*sp)->getPosition();
+            doc.speakerId = (*sp)->getSpeakerId();
+            documents.push_back(doc);
+
+            text.append((*sp)->getScriptView());
+            text.push_back(SEPARATOR);
+        }
+    }
+
+    //folded text; 0 is the sentinel and control bytes below SEPARATOR read as spaces
+    vector<int> folded(text.size() + 1);
+    for (size_t i = 0; i < text.size(); i++){
+        unsigned char c = fold(text[i]);
+        folded[i] = c < (unsigned char)SEPARATOR ? ' ' : c;
+    }
+    folded[text.size()] = 0;
+
+    buildSuffixArray(folded, suffixes, 256);
+    buildLcp(folded, suffixes, lcp);
+
+    built = true;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    buildSeconds = elapsed.count();
+}
+
+/************************************************************/
+// Function name: isBuilt
+// Description: returns whether build has run
+// Parameters: none
+// Return Value: bool - true once built
+/************************************************************/
+bool concordance::isBuilt() const {return built;}
+
+/************************************************************/
+// Function name: getBuildSeconds
+// Description: returns how long the last build took
+// Parameters: none
+// Return Value: double - seconds
+/************************************************************/
+double concordance::getBuildSeconds() const {return buildSeconds;}
+
+/************************************************************/
+// Function name: getLength
+// Description: returns the length of the indexed text, separators included
+// Parameters: none
+// Return Value: size_t - characters
+/************************************************************/
+size_t concordance::getLength() const {return text.size();}
+
+/************************************************************/
+// Function name: memoryBytes
+// Description: Estimates the heap bytes held by the index.
+// Parameters: none
+// Return Value: size_t - bytes
+/************************************************************/
+size_t concordance::memoryBytes() const{
+    size_t bytes = text.capacity() + (suffixes.capacity() + lcp.capacity()) * sizeof(int) + documents.capacity() * sizeof(document);
+    for (size_t e = 0; e < dates.size(); e++)
+        bytes += dates[e].capacity() + eventNames[e].capacity();
+    return bytes;
+}
+
+/************************************************************/
+// Function name: compareSuffix
+// Description: Compares the start of a suffix with a folded phrase.
+// Parameters: int rank - suffix array index
+//             const string& phrase - folded phrase
+// Return Value: int - negative if the suffix sorts before the phrase, 0 if it starts with it, positive if after
+/************************************************************/
+int concordance::compareSuffix(int rank, const string& phrase) const{
+    size_t pos = suffixes[rank];
+    for (size_t i = 0; i < phrase.size(); i++){
+        if (pos + i >= text.size())
+            return -1; //the sentinel sorts first
+        unsigned char a = fold(text[pos + i]), b = phrase[i];
+        if (a < (unsigned char)SEPARATOR)
+            a = ' ';
+        if (a != b)
+            return a < b ? -1 : 1;
+    }
+    return 0;
+}
+
+/************************************************************/
+// Function name: findRange
+// Description: Finds the run of suffixes that start with a phrase. The start is found by binary search; the run is
+//              then extended while neighbouring suffixes share at least the phrase's length.
+// Parameters: const string& phrase - phrase to find, any case
+// Return Value: pair<int, int> - suffix array range [first, second), empty if not found
+/************************************************************/
+pair<int, int> concordance::findRange(const string& phrase) const{
+    string folded;
+    for (char c : phrase)
+        folded.push_back(fold(c));
+    if (folded.empty() || suffixes.empty())
+        return {0, 0};
+
+    int low = 0, high = suffixes.size();
+    while (low < high){
+        int mid = low + (high - low) / 2;
+        if (compareSuffix(mid, folded) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == (int)suffixes.size() || compareSuffix(low, folded) != 0)
+        return {low, low};
+
+    int end = low + 1;
+    while (end < (int)suffixes.size() && lcp[end] >= (int)folded.size())
+        end++;
+    return {low, end};
+}
+
+/************************************************************/
+// Function name: count
+// Description: returns the number of occurrences of a phrase
+// Parameters: const string& phrase - phrase to find
+// Return Value: int - occurrences
+/************************************************************/
+int concordance::count(const string& phrase) const{
+    pair<int, int> range = findRange(phrase);
+    return range.second - range.first;
+}
+
+/************************************************************/
+// Function name: documentAt
+// Description: returns the speech containing a text position
+// Parameters: int pos - position in the joined text
+// Return Value: int - index of the containing speech in documents
+/************************************************************/
+int concordance::documentAt(int pos) const{
+    auto after = upper_bound(documents.begin(), documents.end(), (unsigned int)pos, [](unsigned int p, const document& doc){
+        return p < doc.start;
+    });
+    return (after - documents.begin()) - 1;
+}
+
+//copies text for display, with line breaks and tabs as spaces
+static string flatten(const string& text, size_t start, size_t length){
+    string out = text.substr(start, length);
+    for (char& c : out){
+        if (c == '\n' || c == '\r' || c == '\t')
+            c = ' ';
+    }
+    return out;
+}
+
+/************************************************************/
+// Function name: search
+// Description: Lists every occurrence of a phrase with its context, sorted by speaker, then date, then position.
+// Parameters: const string& phrase - phrase to find, any case
+//             int width - characters of context on each side, cut at the speech's edges
+// Return Value: vector<kwicLine> - occurrences
+/************************************************************/
+vector<kwicLine> concordance::search(const string& phrase, int width) const{
+    pair<int, int> range = findRange(phrase);
+
+    //each hit's speech and speaker name are looked up once, before sorting
+    struct hit{
+        int pos;
+        const document* doc;
+        const string* speaker;
+    };
+    const aliasResolver& aliases = aliasResolver::shared();
+    vector<hit> hits;
+    hits.reserve(range.second - range.first);
+    for (int rank = range.first; rank < range.second; rank++){
+        const document* doc = &documents[documentAt(suffixes[rank])];
+        hits.push_back({suffixes[rank], doc, &aliases.getName(doc->speakerId)});
+    }
+
+    //speaker, date, position, offset order
+    sort(hits.begin(), hits.end(), [&](const hit& a, const hit& b){
+        const document& x = *a.doc;
+        const document& y = *b.doc;
+        if (x.speakerId != y.speakerId)
+            return *a.speaker < *b.speaker;
+        if (dates[x.event] != dates[y.event])
+            return dates[x.event] < dates[y.event];
+        if (x.event != y.event)
+            return x.event < y.event;
+        return a.pos < b.pos;
+    });
+
+    vector<kwicLine> lines;
+    lines.reserve(hits.size());
+    for (const hit& found : hits){
+        int pos = found.pos;
+        const document& doc = *found.doc;
+        size_t docEnd = text.find(SEPARATOR, pos);
+        size_t leftStart = max((long)doc.start, (long)pos - width);
+        size_t rightEnd = min(docEnd, (size_t)pos + phrase.size() + width);
+
+        kwicLine line;
+        line.speaker = *found.speaker;
+        line.date = dates[doc.event];
+        line.eventName = eventNames[doc.event];
+        line.position = doc.position;
+        line.left = flatten(text, leftStart, pos - leftStart);
+        line.match = flatten(text, pos, phrase.size());
+        line.right = flatten(text, pos + phrase.size(), rightEnd - pos - phrase.size());
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+/************************************************************/
+// Function name: exportTsv
+// Description: Writes the concordance of each phrase, one per input line, as tab separated values with a header.
+// Parameters: istream& phrases - phrases, one per line; blank lines are skipped
+//             ostream& out - destination
+//             int width - characters of context on each side
+// Return Value: int - number of rows written
+/************************************************************/
+int concordance::exportTsv(istream& phrases, ostream& out, int width) const{
+    string phrase;
+    int rows = 0;
+
+    out << "phrase\tspeaker\tdate\tevent\tposition\tleft\tmatch\tright\n";
+    while (getline(phrases, phrase)){
+        if (!phrase.empty() && phrase.back() == '\r')
+            phrase.pop_back();
+        if (phrase.empty())
+            continue;
+
+        for (auto& line : search(phrase, width)){
+            out << flatten(phrase, 0, phrase.size()) << '\t' << line.speaker << '\t' << line.date << '\t' << line.eventName << '\t'
+                << line.position << '\t' << line.left << '\t' << line.match << '\t' << line.right << '\n';
+            rows++;
+        }
+    }
+    return rows;
+}
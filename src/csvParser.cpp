@@ -0,0 +1,301 @@
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include "csvParser.h"
+#include "multiversion.h"
+
+using namespace std;
+
+//character classes
+enum {C_OTHER, C_COMMA, C_QUOTE, C_CR, C_LF, C_CLASSES};
+
+//parser states
+enum {S_START, S_UNQUOTED, S_QUOTED, S_QUOTE, S_CR, S_STATES};
+
+//actions taken on a transition
+enum {A_NONE, A_APPEND, A_FIELD, A_RECORD, A_QUOTE, A_STRAY};
+
+struct transition{
+    unsigned char next;
+    unsigned char action;
+};
+
+//state transition table, indexed by [state][character class]
+static const transition TABLE[S_STATES][C_CLASSES] = {
+    //               OTHER                    COMMA                 QUOTE                 CR                   LF
+    /* START    */ {{S_UNQUOTED, A_APPEND}, {S_START, A_FIELD},   {S_QUOTED, A_NONE},   {S_CR, A_RECORD},    {S_START, A_RECORD}},
+    /* UNQUOTED */ {{S_UNQUOTED, A_APPEND}, {S_START, A_FIELD},   {S_UNQUOTED, A_STRAY},{S_CR, A_RECORD},    {S_START, A_RECORD}},
+    /* QUOTED   */ {{S_QUOTED, A_APPEND},   {S_QUOTED, A_APPEND}, {S_QUOTE, A_NONE},    {S_QUOTED, A_APPEND},{S_QUOTED, A_APPEND}},
+    /* QUOTE    */ {{S_UNQUOTED, A_STRAY},  {S_START, A_FIELD},   {S_QUOTED, A_QUOTE},  {S_CR, A_RECORD},    {S_START, A_RECORD}},
+    /* CR       */ {{S_UNQUOTED, A_APPEND}, {S_START, A_FIELD},   {S_QUOTED, A_NONE},   {S_CR, A_RECORD},    {S_START, A_NONE}},
+};
+
+struct classTable{
+    unsigned char cls[256];
+    classTable(){
+        memset(cls, C_OTHER, sizeof(cls));
+        cls[(unsigned char)','] = C_COMMA;
+        cls[(unsigned char)'"'] = C_QUOTE;
+        cls[(unsigned char)'\r'] = C_CR;
+        cls[(unsigned char)'\n'] = C_LF;
+    }
+};
+static const classTable CLASSES;
+
+static const char* REASON_NAMES[CSV_REASON_COUNT] = {
+    "Wrong Field Count",
+    "Bad Date",
+    "Bad Event",
+    "Bad Speaker",
+    "Bad Length",
+    "Missing Length",
+    "Empty Script",
+    "Stray Quote",
+    "Unterminated Quote"
+};
+
+static const int TRANSCRIPT_FIELDS = 6;
+
+/************************************************************/
+// Function name: reasonName
+// Description: returns a printable name for an error reason
+// Parameters: int reason - csvReason value
+// Return Value: const char* - reason name
+/************************************************************/
+const char* csvStats::reasonName(int reason){
+    if (reason < 0 || reason >= CSV_REASON_COUNT)
+        return "Unknown";
+    return REASON_NAMES[reason];
+}
+
+/************************************************************/
+// Function name: isRejection
+// Description: returns whether rows with this reason are dropped, rather than repaired
+// Parameters: int reason - csvReason value
+// Return Value: bool - true if rejected
+/************************************************************/
+bool csvStats::isRejection(int reason){
+    return reason <= CSV_BAD_LENGTH;
+}
+
+//constructor
+csvParser::csvParser(recordCallback callback, csvStats* statsPtr){
+    onRecord = callback;
+    stats = statsPtr;
+
+    state = S_START;
+    fieldCount = 0;
+    line = 1;
+    recordLine = 1;
+    started = false;
+    fields.resize(TRANSCRIPT_FIELDS);
+}
+
+/************************************************************/
+// Function name: endField
+// Description: Closes the current field and opens the next one, reusing old field strings when possible.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void csvParser::endField(){
+    fieldCount++;
+    if (fieldCount == fields.size())
+        fields.emplace_back();
+    fields[fieldCount].clear();
+}
+
+/************************************************************/
+// Function name: endRecord
+// Description: Closes the current record and hands it to the callback. Blank lines are skipped.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void csvParser::endRecord(){
+    size_t count = fieldCount + 1;
+    if (!(count == 1 && fields[0].empty()))
+        onRecord(fields, count, recordLine);
+
+    fieldCount = 0;
+    fields[0].clear();
+    started = false;
+}
+
+//number of newlines in a run of quoted text; the loop vectorizes
+MULTIVERSION
+static size_t countNewlines(const char* data, size_t length){
+    size_t count = 0;
+
+    #pragma omp simd reduction(+:count)
+    for (size_t i = 0; i < length; i++)
+        count += (data[i] == '\n');
+    return count;
+}
+
+/************************************************************/
+// Function name: feed
+// Description: Runs the state machine over the next chunk of input. Records may span chunks.
+// Parameters: const char* data - chunk to parse
+//             size_t size - chunk length
+// Return Value: none
+/************************************************************/
+void csvParser::feed(const char* data, size_t size){
+    size_t i = 0;
+
+    while (i < size){
+        if (!started){
+            recordLine = line;
+            started = true;
+        }
+
+        //bulk copy runs of plain text
+        if (state == S_QUOTED){
+            const char* quote = (const char*)memchr(data + i, '"', size - i);
+            size_t end = quote ? quote - data : size;
+            line += countNewlines(data + i, end - i);
+            fields[fieldCount].append(data + i, end - i);
+            i = end;
+            if (i == size)
+                break;
+        }
+        else if (state == S_UNQUOTED){
+            size_t end = i;
+            while (end < size && CLASSES.cls[(unsigned char)data[end]] == C_OTHER)
+                end++;
+            fields[fieldCount].append(data + i, end - i);
+            i = end;
+            if (i == size)
+                break;
+        }
+
+        char c = data[i++];
+        transition t = TABLE[state][CLASSES.cls[(unsigned char)c]];
+        state = t.next;
+
+        switch (t.action){
+            case A_APPEND:
+                line += (c == '\n');
+                fields[fieldCount].push_back(c);
+                break;
+            case A_FIELD:
+                endField();
+                break;
+            case A_RECORD:
+                line += (c == '\n');
+                endRecord();
+                break;
+            case A_QUOTE:
+                fields[fieldCount].push_back('"');
+                break;
+            case A_STRAY:
+                stats->reasons[CSV_STRAY_QUOTE]++;
+                fields[fieldCount].push_back(c);
+                break;
+            default: //A_NONE
+                if (c == '\n'){ //second half of a CRLF
+                    line++;
+                    started = false;
+                }
+                break;
+        }
+    }
+}
+
+/************************************************************/
+// Function name: finish
+// Description: Flushes the last record when the input does not end in a newline.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void csvParser::finish(){
+    if (state == S_QUOTED)
+        stats->reasons[CSV_UNTERMINATED_QUOTE]++;
+
+    if (started && !(state == S_START && fieldCount == 0 && fields[0].empty()))
+        endRecord();
+
+    state = S_START;
+    started = false;
+}
+
+
+/************************************************************/
+// Function name: parseLength
+// Description: Parses a speaking time without exceptions.
+// Parameters: string_view text - field text
+//             float &length - parsed value, 0 when the field is empty
+// Return Value: bool - false if the text is not a number
+/************************************************************/
+bool parseLength(string_view text, float &length){
+    length = 0.0;
+
+    //trim whitespace
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+        text.remove_suffix(1);
+
+    if (text.empty())
+        return true;
+
+    auto result = from_chars(text.data(), text.data() + text.size(), length);
+    return result.ec == errc() && result.ptr == text.data() + text.size() && length >= 0;
+}
+
+//date fields must look like YYYY-MM-DD
+static bool validDate(const string& date){
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-')
+        return false;
+    for (int i = 0; i < 10; i++){
+        if (i != 4 && i != 7 && (date[i] < '0' || date[i] > '9'))
+            return false;
+    }
+    return true;
+}
+
+/************************************************************/
+// Function name: parseTranscriptRow
+// Description: Validates a record's fields and copies them into a transcript row, counting any problems.
+// Parameters: const vector<string>& fields - record fields
+//             size_t count - number of fields in the record
+//             transcriptRow& row - row to fill
+//             csvStats& stats - error counters
+// Return Value: bool - false if the row must be skipped
+/************************************************************/
+bool parseTranscriptRow(const vector<string>& fields, size_t count, transcriptRow& row, csvStats& stats){
+    stats.records++;
+
+    int reason = -1;
+    if (count != TRANSCRIPT_FIELDS)
+        reason = CSV_FIELD_COUNT;
+    else if (!validDate(fields[0]))
+        reason = CSV_BAD_DATE;
+    else if (fields[1].empty())
+        reason = CSV_BAD_EVENT;
+    else if (fields[3].empty())
+        reason = CSV_BAD_SPEAKER;
+    else if (!parseLength(fields[5], row.length))
+        reason = CSV_BAD_LENGTH;
+
+    if (reason >= 0){
+        stats.reasons[reason]++;
+        stats.rejected++;
+        return false;
+    }
+
+    if (fields[5].find_first_not_of(" \t") == string::npos)
+        stats.reasons[CSV_MISSING_LENGTH]++;
+    if (fields[4].empty())
+        stats.reasons[CSV_EMPTY_SCRIPT]++;
+
+    row.date = fields[0];
+    row.eventName = fields[1];
+    row.section = fields[2];
+    row.speaker = fields[3];
+    row.script = fields[4];
+
+    stats.accepted++;
+    return true;
+}
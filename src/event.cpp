@@ -4,6 +4,7 @@
 #include <map>
 #include <algorithm>
 #include "event.h"
+#include "multiversion.h"
 
 using namespace std;
 
@@ -16,6 +17,7 @@ event::event(){
     speechCount = 0;
     totalWordCount = 0;
     totalSpeakingTime = 0;
+    lastQuestion = false;
 
 }
 
@@ -28,6 +30,7 @@ event::event(string nameString, string dateString){
     speechCount = 0;
     totalWordCount = 0;
     totalSpeakingTime = 0;
+    lastQuestion = false;
 
 }
 
@@ -35,32 +38,63 @@ event::event(string nameString, string dateString){
 // Function name: addSpeech
 // Description: Adds a speech to the event's speeches list. Adds the speaker to the speaker map if necessary.
 // Parameters: speech - speech object to add
+//             string section - debate section the speech is in
 // Return Value: none
 /************************************************************/
-void event::addSpeech(speech sp){
+void event::addSpeech(speech sp, string section){
 
-    speeches.push_front(sp);
+    string speaker = sp.getSpeaker();
 
-    auto it = speeches.front();
+    //a question counts once another speaker answers it
+    if (lastQuestion && speeches.front().getSpeakerId() != sp.getSpeakerId())
+        speakers[speeches.front().getSpeaker()].questions++;
+    lastQuestion = roleModel::isQuestion(sp.getScriptView(), sp.getCount());
+
+    speeches.push_front(sp);
 
     //update event
     speechCount++;
     totalWordCount += sp.getCount();
     totalSpeakingTime += sp.getLength();
+    turns.add(sp.getCount(), sp.getLength());
 
-    string speaker = sp.getSpeaker();
+    //append to the columns
+    if (sections.empty() || sections.back() != section){
+        auto found = find(sections.begin(), sections.end(), section);
+        if (found == sections.end())
+            found = sections.insert(sections.end(), section);
+        sectionColumn.push_back(found - sections.begin());
+    }
+    else{
+        sectionColumn.push_back(sections.size() - 1);
+    }
+    lengthColumn.push_back(sp.getLength());
+    wordColumn.push_back(sp.getCount());
 
     //add new speaker
-    if (speakers.count(speaker) == 0){
-        speakers[speaker] = speakerStats();
+    auto added = speakers.try_emplace(speaker);
+    speakerStats& stats = added.first->second;
+    if (added.second){
+        stats.speakerId = sp.getSpeakerId();
         speakerCount++;
     }
 
     //update speaker stats
-    speakers[speaker].timesSpoke++;
-    speakers[speaker].totalWordCount += sp.getCount();
-    speakers[speaker].totalSpeakingTime += sp.getLength();
-    
+    stats.timesSpoke++;
+    stats.totalWordCount += sp.getCount();
+    stats.totalSpeakingTime += sp.getLength();
+    stats.turns.add(sp.getCount(), sp.getLength());
+
+    paceTotals& pace = stats.pace;
+    pace.turns++;
+    if (sp.isPaceOutlier()){
+        pace.flagged++;
+    }
+    else{
+        pace.words += sp.getCount();
+        pace.time += sp.getLength();
+    }
+
 }
 
 /************************************************************/
@@ -106,15 +140,274 @@ const int event::getWordCount() const {return totalWordCount;}
 // Function name: getTotalTime
 // Description: returns totalSpeakingTime
 // Parameters: none
-// Return Value: int - total speaking time of event
+// Return Value: float - total speaking time of event
+/************************************************************/
+const float event::getTotalTime() const {return totalSpeakingTime;}
+
+/************************************************************/
+// Function name: getSections
+// Description: returns the names of the event's sections, in order of first appearance
+// Parameters: none
+// Return Value: const vector<string>& - section names
+/************************************************************/
+const vector<string>& event::getSections() const {return sections;}
+
+/************************************************************/
+// Function name: getLengthColumn
+// Description: returns the length of each speech, in file order
+// Parameters: none
+// Return Value: const vector<float>& - lengths in seconds
+/************************************************************/
+const vector<float>& event::getLengthColumn() const {return lengthColumn;}
+
+/************************************************************/
+// Function name: getWordColumn
+// Description: returns the word count of each speech, in file order
+// Parameters: none
+// Return Value: const vector<int>& - word counts
+/************************************************************/
+const vector<int>& event::getWordColumn() const {return wordColumn;}
+
+/************************************************************/
+// Function name: getSectionColumn
+// Description: returns the section of each speech, in file order
+// Parameters: none
+// Return Value: const vector<int>& - indexes into getSections()
 /************************************************************/
-const int event::getTotalTime() const {return totalSpeakingTime;}
+const vector<int>& event::getSectionColumn() const {return sectionColumn;}
+
+/************************************************************/
+// Function name: reducePace
+// Description: Sums words and time over turns with a plausible rate, and counts flagged turns.
+//              Runs over the length and word columns with a select instead of a branch so the loop vectorizes.
+// Parameters: const float* lengths - turn lengths
+//             const int* words - turn word counts
+//             const int* sectionIds - turn sections
+//             int section - section to include, or -1 for every turn
+//             size_t n - number of turns
+// Return Value: paceTotals - totals
+/************************************************************/
+MULTIVERSION
+static paceTotals reducePace(const float* lengths, const int* words, const int* sectionIds, int section, size_t n){
+    int wordSum = 0, turns = 0, flagged = 0;
+    float timeSum = 0.0;
+
+    #pragma omp simd reduction(+:wordSum, turns, flagged, timeSum)
+    for (size_t i = 0; i < n; i++){
+        int selected = (section < 0) | (sectionIds[i] == section);
+        float perMinute = words[i] * 60.0f;
+        int valid = selected & (lengths[i] > 0) & (perMinute >= MIN_PACE * lengths[i]) & (perMinute <= MAX_PACE * lengths[i]);
+
+        turns += selected;
+        flagged += selected & !valid;
+        wordSum += valid ? words[i] : 0;
+        timeSum += valid ? lengths[i] : 0.0f;
+    }
+
+    paceTotals totals;
+    totals.words = wordSum;
+    totals.time = timeSum;
+    totals.turns = turns;
+    totals.flagged = flagged;
+    return totals;
+}
+
+/************************************************************/
+// Function name: getPace
+// Description: returns speaking rate totals for the whole event
+// Parameters: none
+// Return Value: paceTotals - totals
+/************************************************************/
+paceTotals event::getPace() const {return reducePace(lengthColumn.data(), wordColumn.data(), sectionColumn.data(), -1, lengthColumn.size());}
+
+/************************************************************/
+// Function name: getSectionPace
+// Description: returns speaking rate totals for one section
+// Parameters: int section - index into getSections()
+// Return Value: paceTotals - totals
+/************************************************************/
+paceTotals event::getSectionPace(int section) const {return reducePace(lengthColumn.data(), wordColumn.data(), sectionColumn.data(), section, lengthColumn.size());}
+
+/************************************************************/
+// Function name: getTurns
+// Description: returns the distribution of all turns in the event
+// Parameters: none
+// Return Value: const turnDistribution& - turn distribution
+/************************************************************/
+const turnDistribution& event::getTurns() const {return turns;}
+
+/************************************************************/
+// Function name: assignRoles
+// Description: Gives every speaker a role and totals the speakers, turns, words and time of each role.
+//              Ingest calls this once the event is fully read.
+// Parameters: const roleModel& model - role table and heuristics
+// Return Value: none
+/************************************************************/
+void event::assignRoles(const roleModel& model){
+    for (auto& totals : roles)
+        totals = roleTotals();
+
+    for (auto& speaker : speakers){
+        speakerStats& stats = speaker.second;
+        stats.role = model.classify(speaker.first, stats.timesSpoke, stats.questions);
+
+        roleTotals& totals = roles[stats.role];
+        totals.speakers++;
+        totals.turns += stats.timesSpoke;
+        totals.words += stats.totalWordCount;
+        totals.time += stats.totalSpeakingTime;
+    }
+}
+
+/************************************************************/
+// Function name: getRoleTotals
+// Description: returns the totals over the speakers with one role
+// Parameters: int role - speakerRole
+// Return Value: const roleTotals& - totals; all zero before assignRoles
+/************************************************************/
+const roleTotals& event::getRoleTotals(int role) const {return roles[role];}
+
+/************************************************************/
+// Function name: getRoleCount
+// Description: returns number of speakers with one role
+// Parameters: int role - speakerRole
+// Return Value: int - speaker count
+/************************************************************/
+int event::getRoleCount(int role) const {return roles[role].speakers;}
 
 /************************************************************/
 // Function name: getSpeakers
 // Description:
 // Parameters: none
-// Return Value: map<string, speakerStats> - map of <speaker name, speaker stats>
+// Return Value: const map<string, speakerStats>& - map of <speaker name, speaker stats>
 /************************************************************/
-map<string, speakerStats> event::getSpeakers() {return speakers;};
+const map<string, speakerStats>& event::getSpeakers() const {return speakers;}
 
+/************************************************************/
+// Function name: getSpeeches
+// Description: returns the event's speeches, most recent first
+// Parameters: none
+// Return Value: const forward_list<speech>& - speeches
+/************************************************************/
+const forward_list<speech>& event::getSpeeches() const {return speeches;}
+
+/************************************************************/
+// Function name: add
+// Description: Records one turn in the sketches and histograms.
+// Parameters: int wordCount - words in the turn
+//             float length - turn length in seconds
+// Return Value: none
+/************************************************************/
+void turnDistribution::add(int wordCount, float length){
+    words.add(wordCount);
+    time.add(length);
+    wordHistogram.add(wordCount);
+    timeHistogram.add(length);
+}
+
+/************************************************************/
+// Function name: merge
+// Description: Folds another distribution into this one.
+// Parameters: const turnDistribution& other - distribution to merge
+// Return Value: none
+/************************************************************/
+void turnDistribution::merge(const turnDistribution& other){
+    words.merge(other.words);
+    time.merge(other.time);
+    wordHistogram.merge(other.wordHistogram);
+    timeHistogram.merge(other.timeHistogram);
+}
+
+/************************************************************/
+// Function name: wordsPerMinute
+// Description: returns speaking rate over the counted turns
+// Parameters: none
+// Return Value: float - words per minute, 0 if no time was counted
+/************************************************************/
+float paceTotals::wordsPerMinute() const{
+    if (time <= 0)
+        return 0.0;
+    return words * 60.0 / time;
+}
+
+/************************************************************/
+// Function name: merge
+// Description: Adds another set of totals to this one.
+// Parameters: const paceTotals& other - totals to add
+// Return Value: none
+/************************************************************/
+void paceTotals::merge(const paceTotals& other){
+    words += other.words;
+    time += other.time;
+    turns += other.turns;
+    flagged += other.flagged;
+}
+
+/************************************************************/
+// Function name: memoryBytes
+// Description: Estimates the heap bytes held by the event, not counting script text, which lives in the scriptStore.
+//              Covers speech nodes, the per speech columns, section names and the speaker map with its sketches.
+// Parameters: none
+// Return Value: size_t - bytes
+/************************************************************/
+size_t event::memoryBytes() const{
+    size_t bytes = sizeof(event) + name.capacity() + date.capacity();
+
+    //list nodes hold a next pointer next to the speech
+    bytes += speechCount * (sizeof(speech) + sizeof(void*));
+    bytes += lengthColumn.capacity() * sizeof(float) + wordColumn.capacity() * sizeof(int) + sectionColumn.capacity() * sizeof(int);
+    for (auto& section : sections)
+        bytes += sizeof(string) + section.capacity();
+    bytes += (turns.words.getRetained() + turns.time.getRetained()) * sizeof(float);
+    bytes += (scoreColumn.capacity() + scores.capacity()) * sizeof(float);
+
+    //map nodes hold three links and a color next to the pair
+    for (auto& speaker : speakers){
+        bytes += sizeof(speaker) + 4 * sizeof(void*) + speaker.first.capacity();
+        bytes += (speaker.second.turns.words.getRetained() + speaker.second.turns.time.getRetained()) * sizeof(float);
+    }
+    return bytes;
+}
+
+/************************************************************/
+// Function name: attachScores
+// Description: Stores the lexicon scores of every speech and sums them per speaker and for the event.
+// Parameters: vector<float> column - scores of each speech in file order, lexiconCount per speech
+//             int lexiconCount - scores per speech
+// Return Value: none
+/************************************************************/
+void event::attachScores(vector<float> column, int lexiconCount){
+    scoreColumn = move(column);
+    scores.assign(lexiconCount, 0.0);
+    for (auto& speaker : speakers)
+        speaker.second.scores.assign(lexiconCount, 0.0);
+
+    //speeches are stored newest first
+    int row = speechCount;
+    for (auto& sp : speeches){
+        row--;
+        if (row < 0 || (size_t)(row + 1) * lexiconCount > scoreColumn.size())
+            continue;
+        vector<float>& speakerScores = speakers[sp.getSpeaker()].scores;
+        for (int l = 0; l < lexiconCount; l++){
+            speakerScores[l] += scoreColumn[row * lexiconCount + l];
+            scores[l] += scoreColumn[row * lexiconCount + l];
+        }
+    }
+}
+
+/************************************************************/
+// Function name: getScoreColumn
+// Description: returns the lexicon scores of each speech, in file order
+// Parameters: none
+// Return Value: const vector<float>& - lexicon count scores per speech; empty until scored
+/************************************************************/
+const vector<float>& event::getScoreColumn() const {return scoreColumn;}
+
+/************************************************************/
+// Function name: getScores
+// Description: returns the event's total score in each lexicon
+// Parameters: none
+// Return Value: const vector<float>& - one total per lexicon; empty until scored
+/************************************************************/
+const vector<float>& event::getScores() const {return scores;}
@@ -0,0 +1,503 @@
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include "exporter.h"
+
+using namespace std;
+
+static const char MAGIC[8] = {'D', 'T', 'T', 'C', 'O', 'L', '1', '\0'};
+
+
+/************************************************************/
+// Function name: addString
+// Description: Appends a value to a utf8 column.
+// Parameters: const string& value - value to append
+// Return Value: none
+/************************************************************/
+void column::addString(const string& value){
+    if (offsets.empty())
+        offsets.push_back(0);
+    bytes.append(value);
+    offsets.push_back(bytes.size());
+}
+
+/************************************************************/
+// Function name: getString
+// Description: returns one value of a utf8 column
+// Parameters: size_t row - row index
+// Return Value: string - value, empty if out of range
+/************************************************************/
+string column::getString(size_t row) const{
+    if (row + 1 >= offsets.size() || offsets[row] < 0 || offsets[row] > offsets[row + 1] || (size_t)offsets[row + 1] > bytes.size())
+        return "";
+    return bytes.substr(offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+/************************************************************/
+// Function name: addColumn
+// Description: Adds an empty column to the table.
+// Parameters: const string& columnName - column name
+//             int type - columnType
+//             const string& dictionary - table the column's codes index into
+// Return Value: column& - new column
+/************************************************************/
+column& table::addColumn(const string& columnName, int type, const string& dictionary){
+    columns.emplace_back();
+    columns.back().name = columnName;
+    columns.back().type = type;
+    columns.back().dictionary = dictionary;
+    return columns.back();
+}
+
+/************************************************************/
+// Function name: find
+// Description: returns a column by name
+// Parameters: const string& columnName - column name
+// Return Value: const column* - column, or nullptr
+/************************************************************/
+const column* table::find(const string& columnName) const{
+    for (auto& col : columns){
+        if (col.name == columnName)
+            return &col;
+    }
+    return nullptr;
+}
+
+//returns the code for a value, adding it to the dictionary table on first use
+static int32_t encode(map<string, int32_t>& codes, table& dictionary, const string& value){
+    auto found = codes.find(value);
+    if (found != codes.end())
+        return found->second;
+
+    int32_t code = dictionary.rows++;
+    codes[value] = code;
+    dictionary.columns[0].addString(value);
+    return code;
+}
+
+/************************************************************/
+// Function name: build
+// Description: Copies the events into columnar tables.
+// Parameters: vector<event*> &allSpeeches - events to export
+//             bool withScripts - include the text of each speech
+// Return Value: shared_ptr<exportSet> - tables
+/************************************************************/
+shared_ptr<exportSet> exportSet::build(vector<event*> &allSpeeches, bool withScripts){
+    shared_ptr<exportSet> set = make_shared<exportSet>();
+    set->tables.resize(5);
+
+    table& events = set->tables[0];
+    table& speakers = set->tables[1];
+    table& sections = set->tables[2];
+    table& stats = set->tables[3];
+    table& speeches = set->tables[4];
+
+    events.name = "events";
+    column& eventName = events.addColumn("name", COL_UTF8);
+    column& eventDate = events.addColumn("date", COL_UTF8);
+    column& eventSpeeches = events.addColumn("speech_count", COL_INT32);
+    column& eventWords = events.addColumn("word_count", COL_INT32);
+    column& eventTime = events.addColumn("speaking_time", COL_FLOAT32);
+    column& eventSpeakers = events.addColumn("speaker_count", COL_INT32);
+
+    speakers.name = "speakers";
+    speakers.addColumn("name", COL_UTF8);
+    sections.name = "sections";
+    sections.addColumn("name", COL_UTF8);
+
+    stats.name = "speaker_stats";
+    column& statsEvent = stats.addColumn("event", COL_INT32, "events");
+    column& statsSpeaker = stats.addColumn("speaker", COL_INT32, "speakers");
+    column& statsTurns = stats.addColumn("times_spoke", COL_INT32);
+    column& statsWords = stats.addColumn("word_count", COL_INT32);
+    column& statsTime = stats.addColumn("speaking_time", COL_FLOAT32);
+    column& statsPacedWords = stats.addColumn("paced_words", COL_INT32);
+    column& statsPacedTime = stats.addColumn("paced_time", COL_FLOAT32);
+    column& statsFlagged = stats.addColumn("flagged_turns", COL_INT32);
+
+    speeches.name = "speeches";
+    column& speechEvent = speeches.addColumn("event", COL_INT32, "events");
+    column& speechSection = speeches.addColumn("section", COL_INT32, "sections");
+    column& speechSpeaker = speeches.addColumn("speaker", COL_INT32, "speakers");
+    column& speechPosition = speeches.addColumn("position", COL_INT32);
+    column& speechLength = speeches.addColumn("length", COL_FLOAT32);
+    column& speechWords = speeches.addColumn("word_count", COL_INT32);
+    column* speechScript = withScripts ? &speeches.addColumn("script", COL_UTF8) : nullptr;
+
+    map<string, int32_t> speakerCodes, sectionCodes;
+
+    for (size_t e = 0; e < allSpeeches.size(); e++){
+        event* ev = allSpeeches[e];
+
+        eventName.addString(ev->getName());
+        eventDate.addString(ev->getDate());
+        eventSpeeches.ints.push_back(ev->getSpeechCount());
+        eventWords.ints.push_back(ev->getWordCount());
+        eventTime.floats.push_back(ev->getTotalTime());
+        eventSpeakers.ints.push_back(ev->getSpeakerCount());
+        events.rows++;
+
+        const map<string, speakerStats>& speakerMap = ev->getSpeakers();
+        for (auto& entry : speakerMap){
+            statsEvent.ints.push_back(e);
+            statsSpeaker.ints.push_back(encode(speakerCodes, speakers, entry.first));
+            statsTurns.ints.push_back(entry.second.timesSpoke);
+            statsWords.ints.push_back(entry.second.totalWordCount);
+            statsTime.floats.push_back(entry.second.totalSpeakingTime);
+            statsPacedWords.ints.push_back(entry.second.pace.words);
+            statsPacedTime.floats.push_back(entry.second.pace.time);
+            statsFlagged.ints.push_back(entry.second.pace.flagged);
+            stats.rows++;
+        }
+
+        //event-local section indexes to global codes
+        vector<int32_t> sectionMap;
+        for (auto& name : ev->getSections())
+            sectionMap.push_back(encode(sectionCodes, sections, name));
+
+        //speech list is newest first; columns are in file order
+        vector<const speech*> ordered;
+        for (auto& sp : ev->getSpeeches())
+            ordered.push_back(&sp);
+
+        const vector<int>& sectionColumn = ev->getSectionColumn();
+        speechLength.floats.insert(speechLength.floats.end(), ev->getLengthColumn().begin(), ev->getLengthColumn().end());
+        speechWords.ints.insert(speechWords.ints.end(), ev->getWordColumn().begin(), ev->getWordColumn().end());
+
+        for (size_t i = 0; i < ordered.size(); i++){
+            const speech* sp = ordered[ordered.size() - 1 - i];
+            speechEvent.ints.push_back(e);
+            speechSection.ints.push_back(i < sectionColumn.size() ? sectionMap[sectionColumn[i]] : -1);
+            speechSpeaker.ints.push_back(encode(speakerCodes, speakers, sp->getSpeaker()));
+            speechPosition.ints.push_back(sp->getPosition());
+            if (speechScript)
+                speechScript->addString(sp->getScript());
+            speeches.rows++;
+        }
+    }
+
+    //empty utf8 columns still need their first offset
+    for (auto& tbl : set->tables){
+        for (auto& col : tbl.columns){
+            if (col.type == COL_UTF8 && col.offsets.empty())
+                col.offsets.push_back(0);
+        }
+    }
+
+    return set;
+}
+
+
+static void writeU32(ofstream& out, uint32_t value){out.write((const char*)&value, sizeof(value));}
+static void writeU64(ofstream& out, uint64_t value){out.write((const char*)&value, sizeof(value));}
+static void writeString(ofstream& out, const string& value){
+    writeU32(out, value.size());
+    out.write(value.data(), value.size());
+}
+static void pad(ofstream& out){
+    static const char zeros[8] = {};
+    long position = out.tellp();
+    if (position % 8)
+        out.write(zeros, 8 - position % 8);
+}
+
+/************************************************************/
+// Function name: write
+// Description: Writes every table to a file. All values are little-endian.
+//              file   = "DTTCOL1\0", u32 table count, tables
+//              table  = string name, u64 rows, u32 column count, columns
+//              column = string name, u8 type, string dictionary, u64 byte length, padding to 8, data, padding to 8
+//              string = u32 length, bytes
+//              utf8 data is rows + 1 int64 offsets followed by the string bytes
+// Parameters: const string& path - file to write
+// Return Value: bool - false if the file could not be written
+/************************************************************/
+bool exportSet::write(const string& path) const{
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out.write(MAGIC, sizeof(MAGIC));
+    writeU32(out, tables.size());
+
+    for (auto& tbl : tables){
+        writeString(out, tbl.name);
+        writeU64(out, tbl.rows);
+        writeU32(out, tbl.columns.size());
+
+        for (auto& col : tbl.columns){
+            writeString(out, col.name);
+            char type = col.type;
+            out.write(&type, 1);
+            writeString(out, col.dictionary);
+
+            if (col.type == COL_INT32){
+                writeU64(out, col.ints.size() * sizeof(int32_t));
+                pad(out);
+                out.write((const char*)col.ints.data(), col.ints.size() * sizeof(int32_t));
+            }
+            else if (col.type == COL_FLOAT32){
+                writeU64(out, col.floats.size() * sizeof(float));
+                pad(out);
+                out.write((const char*)col.floats.data(), col.floats.size() * sizeof(float));
+            }
+            else{
+                writeU64(out, col.offsets.size() * sizeof(int64_t) + col.bytes.size());
+                pad(out);
+                out.write((const char*)col.offsets.data(), col.offsets.size() * sizeof(int64_t));
+                out.write(col.bytes.data(), col.bytes.size());
+            }
+            pad(out);
+        }
+    }
+
+    return out.good();
+}
+
+
+static bool readU32(ifstream& in, uint32_t& value){return (bool)in.read((char*)&value, sizeof(value));}
+static bool readU64(ifstream& in, uint64_t& value){return (bool)in.read((char*)&value, sizeof(value));}
+static bool readString(ifstream& in, string& value){
+    uint32_t length;
+    if (!readU32(in, length) || length > (1u << 30))
+        return false;
+    value.resize(length);
+    return (bool)in.read(&value[0], length);
+}
+static void skipPad(ifstream& in){
+    long position = in.tellg();
+    if (position % 8)
+        in.seekg(8 - position % 8, ios::cur);
+}
+
+/************************************************************/
+// Function name: read
+// Description: Loads a file written by write.
+// Parameters: const string& path - file to read
+// Return Value: shared_ptr<exportSet> - tables, or nullptr if the file is missing or malformed
+/************************************************************/
+shared_ptr<exportSet> exportSet::read(const string& path){
+    ifstream in(path, ios::binary);
+    char magic[8];
+    if (!in.is_open() || !in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        return nullptr;
+
+    //lengths in the file are checked against its size before anything is allocated for them
+    in.seekg(0, ios::end);
+    uint64_t fileSize = in.tellg();
+    in.seekg(sizeof(magic));
+
+    shared_ptr<exportSet> set = make_shared<exportSet>();
+    uint32_t tableCount;
+    if (!readU32(in, tableCount))
+        return nullptr;
+
+    for (uint32_t t = 0; t < tableCount; t++){
+        table tbl;
+        uint64_t rows;
+        uint32_t columnCount;
+        if (!readString(in, tbl.name) || !readU64(in, rows) || !readU32(in, columnCount))
+            return nullptr;
+        //every column holds at least four bytes a row, so this also keeps the byte lengths below from wrapping
+        if (rows > (fileSize - (uint64_t)in.tellg()) / sizeof(int32_t))
+            return nullptr;
+        tbl.rows = rows;
+
+        for (uint32_t c = 0; c < columnCount; c++){
+            column col;
+            char type;
+            uint64_t byteLength;
+            if (!readString(in, col.name) || !in.read(&type, 1) || !readString(in, col.dictionary) || !readU64(in, byteLength))
+                return nullptr;
+            col.type = type;
+            skipPad(in);
+            if (byteLength > fileSize - (uint64_t)in.tellg())
+                return nullptr;
+
+            if (col.type == COL_INT32){
+                if (byteLength != rows * sizeof(int32_t))
+                    return nullptr;
+                col.ints.resize(rows);
+                in.read((char*)col.ints.data(), byteLength);
+            }
+            else if (col.type == COL_FLOAT32){
+                if (byteLength != rows * sizeof(float))
+                    return nullptr;
+                col.floats.resize(rows);
+                in.read((char*)col.floats.data(), byteLength);
+            }
+            else if (col.type == COL_UTF8){
+                uint64_t offsetBytes = (rows + 1) * sizeof(int64_t);
+                if (byteLength < offsetBytes)
+                    return nullptr;
+                col.offsets.resize(rows + 1);
+                in.read((char*)col.offsets.data(), offsetBytes);
+                col.bytes.resize(byteLength - offsetBytes);
+                in.read(&col.bytes[0], byteLength - offsetBytes);
+
+                //offsets start at 0, never decrease and end at the last byte
+                if (col.offsets.front() != 0 || col.offsets.back() != (int64_t)col.bytes.size())
+                    return nullptr;
+                for (uint64_t r = 0; r < rows; r++){
+                    if (col.offsets[r] > col.offsets[r + 1])
+                        return nullptr;
+                }
+            }
+            else{
+                return nullptr;
+            }
+            if (!in)
+                return nullptr;
+            skipPad(in);
+
+            tbl.columns.push_back(move(col));
+        }
+        set->tables.push_back(move(tbl));
+    }
+
+    return set;
+}
+
+/************************************************************/
+// Function name: find
+// Description: returns a table by name
+// Parameters: const string& tableName - table name
+// Return Value: const table* - table, or nullptr
+/************************************************************/
+const table* exportSet::find(const string& tableName) const{
+    for (auto& tbl : tables){
+        if (tbl.name == tableName)
+            return &tbl;
+    }
+    return nullptr;
+}
+
+/************************************************************/
+// Function name: getTables
+// Description: returns every table
+// Parameters: none
+// Return Value: const vector<table>& - tables
+/************************************************************/
+const vector<table>& exportSet::getTables() const {return tables;}
+
+
+//storage behind an exported Arrow schema or array; keeps the export set alive
+struct arrowPrivate{
+    shared_ptr<const exportSet> owner{};
+    string format{}, name{};
+    vector<const void*> buffers{};
+    vector<ArrowSchema*> schemaChildren{};
+    vector<ArrowArray*> arrayChildren{};
+};
+
+static void releaseSchema(ArrowSchema* schema){
+    arrowPrivate* data = (arrowPrivate*)schema->private_data;
+    for (ArrowSchema* child : data->schemaChildren){
+        if (child->release)
+            child->release(child);
+        delete child;
+    }
+    if (schema->dictionary){
+        if (schema->dictionary->release)
+            schema->dictionary->release(schema->dictionary);
+        delete schema->dictionary;
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+static void releaseArray(ArrowArray* array){
+    arrowPrivate* data = (arrowPrivate*)array->private_data;
+    for (ArrowArray* child : data->arrayChildren){
+        if (child->release)
+            child->release(child);
+        delete child;
+    }
+    if (array->dictionary){
+        if (array->dictionary->release)
+            array->dictionary->release(array->dictionary);
+        delete array->dictionary;
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+//fills one column's schema and array; buffers point straight into the column
+static void exportColumn(shared_ptr<const exportSet> owner, const column& col, size_t rows, ArrowSchema* schema, ArrowArray* array){
+    arrowPrivate* schemaData = new arrowPrivate();
+    arrowPrivate* arrayData = new arrowPrivate();
+    schemaData->owner = owner;
+    arrayData->owner = owner;
+    schemaData->name = col.name;
+
+    arrayData->buffers.push_back(nullptr); //no validity bitmap: no nulls
+    if (col.type == COL_INT32){
+        schemaData->format = "i";
+        arrayData->buffers.push_back(col.ints.data());
+    }
+    else if (col.type == COL_FLOAT32){
+        schemaData->format = "f";
+        arrayData->buffers.push_back(col.floats.data());
+    }
+    else{
+        schemaData->format = "U";
+        arrayData->buffers.push_back(col.offsets.data());
+        arrayData->buffers.push_back(col.bytes.data());
+    }
+
+    *schema = ArrowSchema{schemaData->format.c_str(), schemaData->name.c_str(), nullptr, 0, 0, nullptr, nullptr, releaseSchema, schemaData};
+    *array = ArrowArray{(int64_t)rows, 0, 0, (int64_t)arrayData->buffers.size(), 0, arrayData->buffers.data(), nullptr, nullptr, releaseArray, arrayData};
+
+    //dictionary-encoded column: attach the dictionary table's name column as its values
+    const table* dictionary = col.dictionary.empty() ? nullptr : owner->find(col.dictionary);
+    const column* values = dictionary ? dictionary->find("name") : nullptr;
+    if (values){
+        schema->dictionary = new ArrowSchema();
+        array->dictionary = new ArrowArray();
+        exportColumn(owner, *values, dictionary->rows, schema->dictionary, array->dictionary);
+    }
+}
+
+/************************************************************/
+// Function name: exportArrow
+// Description: Exposes a table as an Arrow struct array through the C Data Interface. Column buffers are shared, not copied,
+//              and stay valid until the consumer calls both release callbacks.
+// Parameters: const string& tableName - table to export
+//             ArrowSchema* schema - schema to fill
+//             ArrowArray* array - array to fill
+// Return Value: bool - false if the table does not exist
+/************************************************************/
+bool exportSet::exportArrow(const string& tableName, ArrowSchema* schema, ArrowArray* array) const{
+    const table* tbl = find(tableName);
+    if (!tbl)
+        return false;
+
+    shared_ptr<const exportSet> owner = shared_from_this();
+    arrowPrivate* schemaData = new arrowPrivate();
+    arrowPrivate* arrayData = new arrowPrivate();
+    schemaData->owner = owner;
+    arrayData->owner = owner;
+    schemaData->format = "+s";
+    schemaData->name = tbl->name;
+    arrayData->buffers.push_back(nullptr);
+
+    for (auto& col : tbl->columns){
+        ArrowSchema* childSchema = new ArrowSchema();
+        ArrowArray* childArray = new ArrowArray();
+        exportColumn(owner, col, tbl->rows, childSchema, childArray);
+        schemaData->schemaChildren.push_back(childSchema);
+        arrayData->arrayChildren.push_back(childArray);
+    }
+
+    *schema = ArrowSchema{schemaData->format.c_str(), schemaData->name.c_str(), nullptr, 0, (int64_t)tbl->columns.size(),
+                          schemaData->schemaChildren.data(), nullptr, releaseSchema, schemaData};
+    *array = ArrowArray{(int64_t)tbl->rows, 0, 0, 1, (int64_t)tbl->columns.size(), arrayData->buffers.data(),
+                        arrayData->arrayChildren.data(), nullptr, releaseArray, arrayData};
+    return true;
+}
@@ -0,0 +1,161 @@
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "ingest.h"
+
+using namespace std;
+
+/************************************************************/
+// Function name: degraded
+// Description: returns whether the ingest gave anything up to stay inside its budget
+// Parameters: none
+// Return Value: bool - true if scripts were spilled or dropped, rows sampled, or reading stopped early
+/************************************************************/
+bool ingestBudget::degraded() const{
+    return spilled || dropped || sampleStride > 1 || timedOut;
+}
+
+/************************************************************/
+// Function name: degrade
+// Description: Takes the next step down once the memory budget is passed: spill, then drop, then sample.
+//              A spill that fails falls through to dropping.
+// Parameters: ingestBudget &budget - budget to update
+//             scriptStore &store - store holding the script text
+// Return Value: none
+/************************************************************/
+static void degrade(ingestBudget &budget, scriptStore &store){
+    if (!budget.spilled && !budget.dropped){
+        budget.spilled = store.spill();
+        if (budget.spilled)
+            return;
+    }
+    if (!budget.dropped){
+        store.setDropping(true);
+        budget.dropped = true;
+        return;
+    }
+    budget.sampleStride = min(budget.sampleStride * 2, MAX_SAMPLE_STRIDE);
+}
+
+void ingestTranscripts(istream &in, vector<event*> &allSpeeches, csvStats &stats, size_t chunkSize, timeline* seasons, ingestBudget* budget){
+    int lineNumber = 1;
+    string prevDate = "";
+    bool header = true;
+    transcriptRow row;
+    aliasResolver& aliases = aliasResolver::shared();
+    const roleModel& roles = roleModel::shared();
+    scriptStore& store = scriptStore::shared();
+
+    event* eventObj = nullptr;
+
+    //budget state
+    auto start = chrono::steady_clock::now();
+    size_t finishedBytes = 0; //estimate for every event before the current one
+    size_t nextLimit = budget ? budget->maxBytes : 0;
+    long rowsSeen = 0;
+
+    auto heldBytes = [&](){
+        return finishedBytes + (eventObj ? eventObj->memoryBytes() : 0) + store.memoryBytes() + allSpeeches.capacity() * sizeof(event*);
+    };
+
+    auto checkBudget = [&](){
+        if (budget->maxSeconds > 0){
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            if (elapsed.count() > budget->maxSeconds)
+                budget->timedOut = true;
+        }
+
+        size_t held = heldBytes();
+        budget->peakBytes = max(budget->peakBytes, held);
+        if (budget->maxBytes > 0 && held > nextLimit){
+            if (budget->limitHitAt == 0)
+                budget->limitHitAt = held;
+            degrade(*budget, store);
+            nextLimit = max(budget->maxBytes, heldBytes()) + budget->maxBytes / 16;
+        }
+    };
+
+    //handle each parsed record
+    csvParser parser([&](const vector<string>& fields, size_t count, long){
+        //move past the label line
+        if (header){
+            header = false;
+            return;
+        }
+
+        //out of time: ignore the rest of the stream
+        if (budget && budget->timedOut)
+            return;
+
+        if (!parseTranscriptRow(fields, count, row, stats))
+            return;
+
+        if (budget && ++rowsSeen % BUDGET_CHECK_ROWS == 0){
+            checkBudget();
+            if (budget->timedOut)
+                return;
+        }
+
+        //if line is from a new event, create a new event object
+        if (row.date != prevDate){
+            lineNumber = 1; //reset line number
+            prevDate = row.date;
+
+            //compress the finished event's scripts and settle its roles
+            store.seal();
+            if (eventObj){
+                eventObj->assignRoles(roles);
+                finishedBytes += eventObj->memoryBytes();
+            }
+            if (seasons && eventObj)
+                seasons->addEvent(*eventObj);
+
+            //create new event object
+            eventObj = new event(row.eventName, row.date);
+            allSpeeches.emplace_back(eventObj);
+        }
+        else{
+            lineNumber++;
+        }
+
+        //while sampling, every event still keeps its first row
+        if (budget && (lineNumber - 1) % budget->sampleStride != 0){
+            budget->sampledOut++;
+            return;
+        }
+
+        //add new speech object to event object
+        int speakerId = aliases.resolve(row.speaker);
+        aliases.countUse(speakerId);
+        eventObj->addSpeech(speech(lineNumber, speakerId, row.script, row.length), row.section);
+    }, &stats);
+
+    //read through entire stream in chunks
+    vector<char> buffer(chunkSize > 0 ? chunkSize : 1);
+    while (in){
+        in.read(buffer.data(), buffer.size());
+        parser.feed(buffer.data(), in.gcount());
+
+        if (budget){
+            budget->bytesRead += in.gcount();
+            checkBudget();
+            if (budget->timedOut)
+                break;
+        }
+    }
+    if (!budget || !budget->timedOut)
+        parser.finish();
+
+    store.seal();
+    if (budget)
+        store.setDropping(false);
+    if (eventObj)
+        eventObj->assignRoles(roles);
+    if (seasons && eventObj){
+        seasons->addEvent(*eventObj);
+        seasons->finish();
+    }
+}//end ingestTranscripts
@@ -0,0 +1,533 @@
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <charconv>
+#include <cmath>
+#include "lexicon.h"
+
+using namespace std;
+
+static const char CACHE_MAGIC[8] = {'D', 'T', 'T', 'L', 'E', 'X', '1', '\0'};
+
+//keys per bucket, on average
+static const size_t BUCKET_SIZE = 4;
+
+//give up on a salt after this many displacements for one bucket
+static const uint32_t MAX_DISPLACEMENT = 1 << 20;
+
+//FNV-1a over raw bytes, continuing from hash
+static uint64_t fnv(uint64_t hash, const void* data, size_t length){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < length; i++){
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+//final mix of a 64 bit hash (splitmix64), so the bucket and both slot hashes come from independent bits
+static uint64_t mix(uint64_t x){
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+//constructor
+lexiconSet::lexiconSet(){
+    salt = 0;
+    rejectedLines = 0;
+}
+
+/************************************************************/
+// Function name: parseWeight
+// Description: Reads the weight that follows a word. An empty weight is 1; anything but a whole finite number fails.
+// Parameters: string_view text - rest of the line after the word
+//             float &weight - set to the weight
+// Return Value: bool - false if the weight is malformed
+/************************************************************/
+static bool parseWeight(string_view text, float &weight){
+    weight = 1.0;
+
+    //trim whitespace
+    while (!text.empty() && isspace((unsigned char)text.front()))
+        text.remove_prefix(1);
+    while (!text.empty() && isspace((unsigned char)text.back()))
+        text.remove_suffix(1);
+
+    if (text.empty())
+        return true;
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-')
+        text.remove_prefix(1);
+
+    auto result = from_chars(text.data(), text.data() + text.size(), weight);
+    return result.ec == errc() && result.ptr == text.data() + text.size() && isfinite(weight);
+}
+
+/************************************************************/
+// Function name: shared
+// Description: returns the lexicons used by the application
+// Parameters: none
+// Return Value: lexiconSet& - shared lexicons
+/************************************************************/
+lexiconSet& lexiconSet::shared(){
+    static lexiconSet lexicons;
+    return lexicons;
+}
+
+/************************************************************/
+// Function name: hashWord
+// Description: salted hash of a word
+// Parameters: string_view word - lowercase word
+// Return Value: uint64_t - hash
+/************************************************************/
+uint64_t lexiconSet::hashWord(string_view word) const{
+    return mix(fnv(FNV_OFFSET ^ salt, word.data(), word.size()));
+}
+
+/************************************************************/
+// Function name: add
+// Description: Reads one lexicon of "word [weight]" lines. Blank lines and lines starting with # are skipped, and
+//              lines whose weight is not a number are skipped and counted. Words are lowercased; a word already in
+//              the lexicon keeps its last weight.
+// Parameters: const string& name - lexicon name
+//             istream &in - lexicon text
+// Return Value: bool - false if the lexicon has no words
+/************************************************************/
+bool lexiconSet::add(const string& name, istream &in){
+    size_t lexicon = names.size();
+    size_t count = lexicon + 1;
+
+    //widen the weight rows for the new lexicon
+    vector<float> widened(words.size() * count, 0.0);
+    for (size_t w = 0; w < words.size(); w++){
+        copy(&weights[w * lexicon], &weights[w * lexicon] + lexicon, &widened[w * count]);
+    }
+
+    //existing keys by word, for words shared with earlier lexicons
+    vector<int> byWord(words.size());
+    iota(byWord.begin(), byWord.end(), 0);
+    sort(byWord.begin(), byWord.end(), [&](int a, int b){ return words[a] < words[b]; });
+
+    string line, word, rest;
+    size_t added = 0;
+    while (getline(in, line)){
+        istringstream fields(line);
+        if (!(fields >> word) || word[0] == '#')
+            continue;
+
+        float weight;
+        getline(fields, rest);
+        if (!parseWeight(rest, weight)){
+            rejectedLines++;
+            continue;
+        }
+        for (char& c : word)
+            c = tolower((unsigned char)c);
+
+        auto found = lower_bound(byWord.begin(), byWord.end(), word, [&](int index, const string& key){ return words[index] < key; });
+        size_t index;
+        if (found != byWord.end() && words[*found] == word){
+            index = *found;
+        }
+        else{
+            index = words.size();
+            words.push_back(word);
+            widened.resize(words.size() * count, 0.0);
+            byWord.insert(found, index);
+        }
+        widened[index * count + lexicon] = weight;
+        added++;
+    }
+
+    if (added == 0)
+        return false;
+
+    names.push_back(name);
+    weights.swap(widened);
+    return buildHash();
+}
+
+/************************************************************/
+// Function name: loadDirectory
+// Description: Reads every .txt file in a directory as a lexicon named after the file, in name order.
+// Parameters: const string& path - directory
+// Return Value: int - lexicons read, -1 if the directory could not be read
+/************************************************************/
+int lexiconSet::loadDirectory(const string& path){
+    error_code error;
+    vector<filesystem::path> files;
+    for (auto& entry : filesystem::directory_iterator(path, error)){
+        if (entry.is_regular_file() && entry.path().extension() == ".txt")
+            files.push_back(entry.path());
+    }
+    if (error)
+        return -1;
+    sort(files.begin(), files.end());
+
+    int count = 0;
+    for (auto& file : files){
+        ifstream in(file);
+        if (in.is_open() && add(file.stem().string(), in))
+            count++;
+    }
+    return count;
+}
+
+/************************************************************/
+// Function name: clear
+// Description: Removes every lexicon.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void lexiconSet::clear(){
+    names.clear();
+    words.clear();
+    weights.clear();
+    displacements.clear();
+    slots.clear();
+    salt = 0;
+    rejectedLines = 0;
+}
+
+/************************************************************/
+// Function name: buildHash
+// Description: Builds the perfect hash over every word. Each key has a bucket and a pair of slot hashes (f, g);
+//              with displacement d its slot is (f + d * g) mod slots. Buckets are placed largest first, each taking
+//              the smallest d that lands all of its keys in free slots. If a bucket finds no such d, the salt changes
+//              and the build starts over.
+// Parameters: none
+// Return Value: bool - true once built
+/************************************************************/
+bool lexiconSet::buildHash(){
+    size_t n = words.size();
+    size_t slotCount = n + n / 8 + 1;
+    size_t bucketCount = n / BUCKET_SIZE + 1;
+
+    for (salt = 0; salt < 64; salt++){
+        vector<vector<int> > buckets(bucketCount);
+        vector<uint64_t> hashes(n);
+        for (size_t i = 0; i < n; i++){
+            hashes[i] = hashWord(words[i]);
+            buckets[(hashes[i] >> 40) % bucketCount].push_back(i);
+        }
+
+        vector<int> order(bucketCount);
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int a, int b){ return buckets[a].size() > buckets[b].size(); });
+
+        displacements.assign(bucketCount, 0);
+        slots.assign(slotCount, -1);
+        bool placed = true;
+        vector<size_t> taken;
+
+        for (int b : order){
+            if (buckets[b].empty())
+                break;
+
+            uint32_t d = 0;
+            for (; d < MAX_DISPLACEMENT; d++){
+                taken.clear();
+                for (int key : buckets[b]){
+                    uint64_t f = (uint32_t)hashes[key] % slotCount;
+                    uint64_t g = (hashes[key] >> 20) % (slotCount > 1 ? slotCount - 1 : 1) + 1;
+                    size_t slot = (f + d * g) % slotCount;
+                    if (slots[slot] >= 0 || find(taken.begin(), taken.end(), slot) != taken.end())
+                        break;
+                    taken.push_back(slot);
+                }
+                if (taken.size() == buckets[b].size())
+                    break;
+            }
+            if (d == MAX_DISPLACEMENT){
+                placed = false;
+                break;
+            }
+
+            displacements[b] = d;
+            for (size_t k = 0; k < taken.size(); k++)
+                slots[taken[k]] = buckets[b][k];
+        }
+
+        if (placed)
+            return true;
+    }
+
+    displacements.clear();
+    slots.clear();
+    return false;
+}
+
+/************************************************************/
+// Function name: lookup
+// Description: finds a word in the lexicons
+// Parameters: string_view word - lowercase word
+// Return Value: int - key index for getWeights, -1 if no lexicon has the word
+/************************************************************/
+int lexiconSet::lookup(string_view word) const{
+    if (slots.empty())
+        return -1;
+
+    uint64_t hash = hashWord(word);
+    size_t slotCount = slots.size();
+    uint64_t f = (uint32_t)hash % slotCount;
+    uint64_t g = (hash >> 20) % (slotCount > 1 ? slotCount - 1 : 1) + 1;
+    uint32_t d = displacements[(hash >> 40) % displacements.size()];
+
+    int index = slots[(f + d * g) % slotCount];
+    if (index < 0 || words[index] != word)
+        return -1;
+    return index;
+}
+
+/************************************************************/
+// Function name: getWeights
+// Description: returns a word's weight in every lexicon
+// Parameters: int index - key index from lookup
+// Return Value: const float* - getCount() weights, 0 where a lexicon lacks the word
+/************************************************************/
+const float* lexiconSet::getWeights(int index) const {return &weights[index * names.size()];}
+
+/************************************************************/
+// Function name: score
+// Description: Adds the weights of a script's words to a score per lexicon. Words are lowercase runs of letters,
+//              digits and apostrophes.
+// Parameters: string_view script - text to score
+//             float* scores - getCount() running scores
+// Return Value: none
+/************************************************************/
+void lexiconSet::score(string_view script, float* scores) const{
+    size_t count = names.size();
+    char word[64];
+    size_t length = 0;
+    bool tooLong = false;
+
+    for (size_t i = 0; i <= script.size(); i++){
+        unsigned char c = i < script.size() ? script[i] : ' ';
+        if (isalnum(c) || c == '\''){
+            if (length < sizeof(word))
+                word[length++] = tolower(c);
+            else
+                tooLong = true;
+            continue;
+        }
+        if (length > 0 && !tooLong){
+            int index = lookup(string_view(word, length));
+            if (index >= 0){
+                const float* row = getWeights(index);
+                for (size_t l = 0; l < count; l++)
+                    scores[l] += row[l];
+            }
+        }
+        length = 0;
+        tooLong = false;
+    }
+}
+
+/************************************************************/
+// Function name: getCount
+// Description: returns number of lexicons
+// Parameters: none
+// Return Value: int - lexicon count
+/************************************************************/
+int lexiconSet::getCount() const {return names.size();}
+
+/************************************************************/
+// Function name: getName
+// Description: returns a lexicon's name
+// Parameters: int lexicon - lexicon index
+// Return Value: const string& - name, the file name without its extension
+/************************************************************/
+const string& lexiconSet::getName(int lexicon) const {return names.at(lexicon);}
+
+/************************************************************/
+// Function name: getWordCount
+// Description: returns number of distinct words over every lexicon
+// Parameters: none
+// Return Value: size_t - word count
+/************************************************************/
+size_t lexiconSet::getWordCount() const {return words.size();}
+
+/************************************************************/
+// Function name: getSlotCount
+// Description: returns size of the perfect hash table
+// Parameters: none
+// Return Value: size_t - slots, a little more than the word count
+/************************************************************/
+size_t lexiconSet::getSlotCount() const {return slots.size();}
+
+/************************************************************/
+// Function name: getRejectedLines
+// Description: returns how many lines were skipped for a malformed weight
+// Parameters: none
+// Return Value: size_t - rejected lines since the last clear
+/************************************************************/
+size_t lexiconSet::getRejectedLines() const {return rejectedLines;}
+
+/************************************************************/
+// Function name: fingerprint
+// Description: hash of every lexicon's name, words and weights
+// Parameters: none
+// Return Value: uint64_t - fingerprint
+/************************************************************/
+uint64_t lexiconSet::fingerprint() const{
+    uint64_t hash = FNV_OFFSET;
+    for (auto& name : names)
+        hash = fnv(hash, name.c_str(), name.size() + 1);
+    for (auto& word : words)
+        hash = fnv(hash, word.c_str(), word.size() + 1);
+    return fnv(hash, weights.data(), weights.size() * sizeof(float));
+}
+
+
+//a run of speeches from one event
+struct scoreBatch{
+    int eventIndex;
+    int first, count;
+};
+
+void scoreEvents(const vector<event*> &events, const lexiconSet &lexicons, int threads){
+    int count = lexicons.getCount();
+    if (count == 0)
+        return;
+
+    //speeches in file order, and the batches covering them
+    vector<vector<scriptHandle> > handles(events.size());
+    vector<vector<float> > columns(events.size());
+    vector<scoreBatch> batches;
+    for (size_t e = 0; e < events.size(); e++){
+        for (auto& sp : events[e]->getSpeeches())
+            handles[e].push_back(sp.getScriptHandle());
+        reverse(handles[e].begin(), handles[e].end());
+        columns[e].assign(handles[e].size() * count, 0.0);
+
+        for (int first = 0; first < (int)handles[e].size(); first += SCORE_BATCH_SPEECHES)
+            batches.push_back({(int)e, first, min(SCORE_BATCH_SPEECHES, (int)handles[e].size() - first)});
+    }
+
+    //each worker takes the next batch until none are left, keeping the last block it decompressed
+    const scriptStore& store = scriptStore::shared();
+    atomic<size_t> next(0);
+    auto work = [&](){
+        int cachedBlock = -1;
+        string text;
+        for (size_t b = next++; b < batches.size(); b = next++){
+            const scoreBatch& batch = batches[b];
+            for (int s = batch.first; s < batch.first + batch.count; s++){
+                scriptHandle handle = handles[batch.eventIndex][s];
+                if (handle.block < 0)
+                    continue;
+                if (handle.block != cachedBlock){
+                    text = store.readBlock(handle.block);
+                    cachedBlock = handle.block;
+                }
+                if ((size_t)handle.offset + handle.length <= text.size())
+                    lexicons.score(string_view(text).substr(handle.offset, handle.length), &columns[batch.eventIndex][s * count]);
+            }
+        }
+    };
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, (int)batches.size());
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(work);
+    work();
+    for (auto& worker : pool)
+        worker.join();
+
+    for (size_t e = 0; e < events.size(); e++)
+        events[e]->attachScores(move(columns[e]), count);
+}
+
+//hash of what the scores depend on besides the lexicons: every event's speeches, by word count, length and text.
+//the text comes in through the checksums the store took when each block was sealed
+static uint64_t eventsFingerprint(const vector<event*> &events){
+    const scriptStore& store = scriptStore::shared();
+    uint64_t hash = FNV_OFFSET;
+    for (const event* ev : events){
+        string name = ev->getName() + '\n' + ev->getDate();
+        hash = fnv(hash, name.c_str(), name.size() + 1);
+        hash = fnv(hash, ev->getWordColumn().data(), ev->getWordColumn().size() * sizeof(int));
+        hash = fnv(hash, ev->getLengthColumn().data(), ev->getLengthColumn().size() * sizeof(float));
+
+        int lastBlock = -1;
+        for (const speech& s : ev->getSpeeches()){
+            scriptHandle handle = s.getScriptHandle();
+            if (handle.block != lastBlock){
+                uint64_t blockHash = store.getChecksum(handle.block);
+                hash = fnv(hash, &blockHash, sizeof(blockHash));
+                lastBlock = handle.block;
+            }
+            hash = fnv(hash, &handle, sizeof(handle));
+        }
+    }
+    return hash;
+}
+
+bool writeScoreCache(const string &path, const vector<event*> &events, const lexiconSet &lexicons){
+    ofstream out(path, ios::binary);
+    if (!out.is_open())
+        return false;
+
+    uint64_t lexiconHash = lexicons.fingerprint(), eventHash = eventsFingerprint(events);
+    uint32_t count = lexicons.getCount(), eventCount = events.size();
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    out.write((const char*)&lexiconHash, sizeof(lexiconHash));
+    out.write((const char*)&eventHash, sizeof(eventHash));
+    out.write((const char*)&count, sizeof(count));
+    out.write((const char*)&eventCount, sizeof(eventCount));
+
+    for (const event* ev : events){
+        const vector<float>& column = ev->getScoreColumn();
+        uint64_t length = column.size();
+        out.write((const char*)&length, sizeof(length));
+        out.write((const char*)column.data(), length * sizeof(float));
+    }
+    return (bool)out;
+}
+
+bool readScoreCache(const string &path, const vector<event*> &events, const lexiconSet &lexicons){
+    ifstream in(path, ios::binary);
+    char magic[8];
+    uint64_t lexiconHash, eventHash;
+    uint32_t count, eventCount;
+    if (!in.is_open() || !in.read(magic, sizeof(magic)) || memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+        return false;
+    if (!in.read((char*)&lexiconHash, sizeof(lexiconHash)) || !in.read((char*)&eventHash, sizeof(eventHash))
+        || !in.read((char*)&count, sizeof(count)) || !in.read((char*)&eventCount, sizeof(eventCount)))
+        return false;
+    if (lexiconHash != lexicons.fingerprint() || count != (uint32_t)lexicons.getCount() || eventCount != events.size()
+        || eventHash != eventsFingerprint(events))
+        return false;
+
+    //read every column before attaching any, so a truncated file changes nothing
+    vector<vector<float> > columns(events.size());
+    for (size_t e = 0; e < events.size(); e++){
+        uint64_t length;
+        if (!in.read((char*)&length, sizeof(length)) || length != (uint64_t)events[e]->getSpeechCount() * count)
+            return false;
+        columns[e].resize(length);
+        if (!in.read((char*)columns[e].data(), length * sizeof(float)))
+            return false;
+    }
+
+    for (size_t e = 0; e < events.size(); e++)
+        events[e]->attachScores(move(columns[e]), count);
+    return true;
+}
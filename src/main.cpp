@@ -22,14 +22,42 @@ Each datum includes the date of the event, the event name, the section of the de
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <map>
 #include <algorithm>
 #include <vector>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <memory>
+#include <chrono>
 #include "event.h"
+#include "exporter.h"
+#include "aliases.h"
+#include "concordance.h"
+#include "compare.h"
+#include "pager.h"
+#include "ingest.h"
+#include "timeline.h"
+#include "roles.h"
+#include "lexicon.h"
 
 using namespace std;
 
+//transcript data, read from the working directory
+const string TRANSCRIPT_FILE = "debate_transcripts_v3_2020-02-26.csv";
+
+//speaker alias table, read from the working directory if present
+const string ALIAS_FILE = "speaker_aliases.txt";
+
+//known candidates and moderators, read from the working directory if present
+const string ROLE_FILE = "speaker_roles.txt";
+
+//word lists to score speeches with, and where their scores are kept between runs
+const string LEXICON_DIR = "lexicons";
+const string SCORE_CACHE = "lexicon_scores.bin";
+
 
 /*!
 *   \fn eventDetails
@@ -53,50 +81,44 @@ void eventDetails(event* eventToStat);
 */   
 void eventsMenu(vector<event*> &allSpeeches);
 
-/*!
-*   \fn getLength
-*	\param string line - CSV line to read from
-*	\param size_t &startPos - Line index to read from (called on the comma).
-*	\return float - speaking time in seconds
-*   
-*   \par Description
-*   Reads the speaking time length from the end of a line of the CSV. Updates the start position.
-*/   
-int getLength(string line, size_t &startPos);
-
 /*!
 *   \fn mainMenu
 *	\param vector<event*> &allSpeeches
+*	\param timeline &seasons - Per-speaker statistics of every event
+*	\param const ingestBudget &budget - Memory limit given on the command line, also applied to the phrase index
 *	\return void
 *   
 *   \par Description
 *   Displays a menu prompting for either speaker or event information.
 */   
-void mainMenu(vector<event*> &allSpeeches);
+void mainMenu(vector<event*> &allSpeeches, timeline &seasons, const ingestBudget &budget);
 
 /*!
-*   \fn nextCSV
-*	\param string line - CSV line to read from
-*	\param size_t &startPos - Line index to read from (called after the comma).
-*	\return string - CSV data
+*   \fn printEventAttendeesStats
+*	\param vector<pair<string,speakerStats>> &speakers - Vector containing pairs of <speaker name, speaker stats>
+*	\param vector<int> &order - Indexes into speakers, in display order
+*	\param int mode - Determines what to print
+*           - 0 - Called from eventDetails: Printing information pertaining only to that event (No total attendance)
+*           - 1 - Called from speakerMenu: Printing information pertaining to every event (Total attendance)
+*	\return void
 *   
 *   \par Description
-*   Reads next value from a line of the CSV file. Updates the start position.
+*   Prints a table of stats for all attendees of a single event, one page at a time.
 */   
-string nextCSV(string line, size_t &startPos);
+void printEventAttendeesStats(vector<pair <string, speakerStats> > &speakers, vector<int> &order, string name, int mode);
 
 /*!
-*   \fn printEventAttendeesStats
+*   \fn printTurnDistributions
 *	\param vector<pair<string,speakerStats>> &speakers - Vector containing pairs of <speaker name, speaker stats>
-*	\param int mode - Determines what to print
-*           - 0 - Called from eventDetails: Printing information pertaining only to that event (No total attendance)
-*           - 1 - Called from speakerMenu: Printing information pertaining to every event (Total attendance)
+*	\param vector<int> &order - Indexes into speakers, in display order
+*	\param string name - Table title
+*	\param const turnDistribution &overall - Distribution of every turn in the table
 *	\return void
 *   
 *   \par Description
-*   Prints a table of stats for all attendees of a single event.
+*   Prints the median, 90th, 99th percentile and longest turn of each speaker, then histograms of all turns.
 */   
-void printEventAttendeesStats(vector<pair <string, speakerStats> > &speakers, string name, int mode);
+void printTurnDistributions(vector<pair <string, speakerStats> > &speakers, vector<int> &order, string name, const turnDistribution &overall);
 
 /*!
 *   \fn printEvents
@@ -108,220 +130,402 @@ void printEventAttendeesStats(vector<pair <string, speakerStats> > &speakers, st
 */   
 void printEvents(vector<event*> &allSpeeches);
 
+/*!
+*   \fn printSectionPace
+*	\param event* eventToStat - Event whose sections to print
+*	\return void
+*   
+*   \par Description
+*   Prints the word count, time and speaking rate of each section of an event.
+*/   
+void printSectionPace(event* eventToStat);
+
+/*!
+*   \fn printStorageStats
+*	\return void
+*   
+*   \par Description
+*   Prints the script store's compressed size and decompression throughput.
+*/   
+void printStorageStats();
+
+/*!
+*   \fn exportData
+*	\param vector<event*> &allSpeeches - Vector containing every event
+*	\return void
+*   
+*   \par Description
+*   Writes the events, speaker statistics and speeches to a columnar file chosen by the user.
+*/   
+void exportData(vector<event*> &allSpeeches);
+
+/*!
+*   \fn printAliasSuggestions
+*	\return void
+*   
+*   \par Description
+*   Prints speaker names that are probably spellings of the same person but are not in the alias table.
+*/   
+void printAliasSuggestions();
+
+/*!
+*   \fn concordanceMenu
+*	\param vector<event*> &allSpeeches - Vector containing every event
+*	\param const ingestBudget &budget - Memory limit; the menu does not open if the index would not fit in it
+*	\return void
+*   
+*   \par Description
+*   Lists every occurrence of a phrase with its surrounding text, or writes the listings for a file of phrases.
+*   The index is built each time the menu is opened and freed when it is left, since it holds about nine bytes per
+*   character of script.
+*/   
+void concordanceMenu(vector<event*> &allSpeeches, const ingestBudget &budget);
+
+/*!
+*   \fn compareEvents
+*	\param vector<event*> &selected - Events to compare, in display order
+*	\param const eventComparer &comparer - Dense statistics of every event
+*	\return void
+*   
+*   \par Description
+*   Prints each speaker's word count, time, turns and share of every selected event side by side, with the change in
+*   share from the first event, followed by the similarity of each pair of events.
+*/   
+void compareEvents(vector<event*> &selected, const eventComparer &comparer);
+
+/*!
+*   \fn printSimilarEvents
+*	\param vector<event*> &allSpeeches - Vector containing every event, in display order
+*	\param const eventComparer &comparer - Dense statistics of every event
+*	\return void
+*   
+*   \par Description
+*   Lists, one page at a time, each event's closest events by speaker share cosine similarity and by vocabulary
+*   Jensen-Shannon divergence, taken from the all-pairs matrices.
+*/   
+void printSimilarEvents(vector<event*> &allSpeeches, const eventComparer &comparer);
+
 /*!
 *   \fn readFile
 *	\param vector<event*> &allSpeeches - Vector to contain every event
+*	\param timeline &seasons - Timeline to fill while reading
+*	\param ingestBudget &budget - Memory and time limits for reading
+*	\return bool - false if the file could not be opened
+*   
+*   \par Description
+*   Reads the entire CSV file in the events vector, then reports anything given up to stay inside the budget.
+*/   
+bool readFile(vector<event*> &allSpeeches, timeline &seasons, ingestBudget &budget);
+
+/*!
+*   \fn parseArguments
+*	\param int argc - Argument count
+*	\param char* argv[] - Arguments
+*	\param ingestBudget &budget - Budget to fill from --max-memory (MB) and --max-seconds
+*	\param int &benchRuns - Set from --bench-ingest; left alone if the option is absent
+*	\return bool - false if an argument was not recognized, not a positive number or too large a memory budget
+*   
+*   \par Description
+*   Reads the command line. Each option takes its value after a space or an equals sign.
+*/   
+bool parseArguments(int argc, char* argv[], ingestBudget &budget, int &benchRuns);
+
+/*!
+*   \fn benchIngest
+*	\param int runs - Number of times to ingest the file
+*	\return int - exit status
+*   
+*   \par Description
+*   Reads the transcript file into memory once, then times the full ingest path over it several times and prints
+*   one line with the best and median throughput. Used by the makefile's bench target to compare build variants.
+*/   
+int benchIngest(int runs);
+
+/*!
+*   \fn sortOrder
+*	\param vector<int> &order - Indexes into speakers, rearranged into sorted order
+*	\param vector<pair<string,speakerStats>> &speakers - Vector containing pairs of <speaker name, speaker stats>
+*	\param Compare compare - One of the event::sortSpeakers comparators
 *	\return void
 *   
 *   \par Description
-*   Reads the entire CSV file in the events vector
+*   Sorts a permutation of the speakers vector, leaving the speakers themselves in place.
+*/   
+template <class Compare>
+void sortOrder(vector<int> &order, vector<pair <string, speakerStats> > &speakers, Compare compare){
+    sort(order.begin(), order.end(), [&](int a, int b){ return compare(speakers[a], speakers[b]); });
+}
+
+/*!
+*   \fn filterByRole
+*	\param vector<int> &order - Indexes into speakers, replaced by the speakers with the chosen role
+*	\param vector<pair<string,speakerStats>> &speakers - Vector containing pairs of <speaker name, speaker stats>
+*	\return bool - false if no valid role was chosen, leaving order unchanged
+*   
+*   \par Description
+*   Asks for a role and keeps only the speakers with it, in name order. Choosing all roles restores every speaker.
 */   
-void readFile(vector<event*> &allSpeeches);
+bool filterByRole(vector<int> &order, vector<pair <string, speakerStats> > &speakers);
 
 /*!
 *   \fn speakerMenu
 *	\param vector<event*> &allSpeeches - Vector containing every event
+*	\param const timeline &seasons - Per-speaker statistics of every event
 *	\return void
 *   
 *   \par Description
 *   Collects each unique speaker from every event, talleying their individual stats. 
 *   Then displays a menu of sort options.
 */   
-void speakerMenu(vector<event*> &allSpeeches);
+void speakerMenu(vector<event*> &allSpeeches, const timeline &seasons);
 
 /*!
-*   \fn Main
-*	\param 
+*   \fn speakerDetails
+*	\param const string &name - Speaker's canonical name
+*	\param int speakerId - Speaker's interned id
+*	\param const timeline &seasons - Per-speaker statistics of every event
 *	\return void
 *   
 *   \par Description
+*   Prints a speaker's statistics in each event they spoke in, in date order, with the change in their share of
+*   speaking time, their rank in each event and their trend over the season.
+*/   
+void speakerDetails(const string &name, int speakerId, const timeline &seasons);
+
+/*!
+*   \fn Main
+*	\param int argc - Argument count
+*	\param char* argv[] - Arguments: [--max-memory MB] [--max-seconds N] [--bench-ingest RUNS]
+*	\return int - exit status
+*   
+*   \par Description
 *   Instantiates the events vector. Reads in the event data. Displays the main menu.
 */   
-int main(){
+int main(int argc, char* argv[]){
     vector<event*> allSpeeches;
-    readFile(allSpeeches);
-    mainMenu(allSpeeches);
+    timeline seasons;
+    ingestBudget budget;
+    int benchRuns = 0;
+
+    if (!parseArguments(argc, argv, budget, benchRuns)){
+        cout << "Usage: " << argv[0] << " [--max-memory MB] [--max-seconds N] [--bench-ingest RUNS]" << endl;
+        return EXIT_FAILURE;
+    }
+    if (benchRuns > 0){
+        return benchIngest(benchRuns);
+    }
+    if (!readFile(allSpeeches, seasons, budget)){
+        return EXIT_FAILURE;
+    }
+    mainMenu(allSpeeches, seasons, budget);
+
+    for (event* eventObj : allSpeeches){
+        delete eventObj;
+    }
+    return EXIT_SUCCESS;
 }
 
 
 
-int getLength(string line, size_t &startPos){
-    int length;
-    startPos++;
+bool parseArguments(int argc, char* argv[], ingestBudget &budget, int &benchRuns){
+    for (int i = 1; i < argc; i++){
+        string option = argv[i];
+        string value;
 
-    //Some lines have no length; Default to 0.0
+        //value after '=' or in the next argument
+        size_t equals = option.find('=');
+        if (equals != string::npos){
+            value = option.substr(equals + 1);
+            option = option.substr(0, equals);
+        }
+        else if (i + 1 < argc){
+            value = argv[++i];
+        }
 
-    //don't crash if reading in nothing
-    try{
-        length = stoi(line.substr(startPos, string::npos));
-    }
-    catch(const std::exception& e){
-        return 0;
+        double number = 0;
+        try{ //check if number
+            number = stod(value);
+        }
+        catch(const std::exception& e){
+            cout << "Expected a number after " << option << "." << endl;
+            return false;
+        }
+        if (!(number > 0) || !isfinite(number)){
+            cout << option << " must be positive." << endl;
+            return false;
+        }
+
+        if (option == "--max-memory"){
+            //larger values do not fit in size_t, and converting them is undefined
+            if (number >= numeric_limits<size_t>::max() / (1024.0 * 1024.0)){
+                cout << option << " is too large." << endl;
+                return false;
+            }
+            budget.maxBytes = number * 1024 * 1024;
+        }
+        else if (option == "--max-seconds"){
+            budget.maxSeconds = number;
+        }
+        else if (option == "--bench-ingest"){
+            benchRuns = max(1, (int)min(number, (double)numeric_limits<int>::max()));
+        }
+        else{
+            cout << "Unknown option " << option << "." << endl;
+            return false;
+        }
     }
-    return length;
+    return true;
 }
 
 
 
-string nextCSV(string line, size_t &startPos){
-    
-    //starting after comma
-
-    size_t newPos = 0;
-    //Read until next quote
-    if (line[startPos] == '"'){
-        startPos++;
-        newPos = line.find('"', startPos);
+int benchIngest(int runs){
+    ifstream transcriptFile(TRANSCRIPT_FILE, ios::binary);
+    if (!transcriptFile.is_open()){
+        cout << "Failed to open file." << endl;
+        return EXIT_FAILURE;
     }
-    else //read until next comma
-        newPos = line.find(',', startPos);
-
-    if (newPos >= string::npos)
-        return "Failure";
-    else{
-        string val = line.substr(startPos, newPos - startPos);
-        startPos = newPos;
-        if (line[startPos] == '"'){
-            startPos++; //eat end quote
+    string data((istreambuf_iterator<char>(transcriptFile)), istreambuf_iterator<char>());
+
+    //same tables as a normal run, so ingest does the same work
+    aliasResolver::shared().loadFile(ALIAS_FILE);
+    roleModel::shared().loadFile(ROLE_FILE);
+
+    vector<double> seconds;
+    long rows = 0;
+    for (int run = 0; run < runs; run++){
+        vector<event*> events;
+        csvStats stats;
+        istringstream in(data);
+
+        auto start = chrono::steady_clock::now();
+        ingestTranscripts(in, events, stats);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        seconds.push_back(elapsed.count());
+        rows = stats.accepted;
+
+        for (event* eventObj : events){
+            delete eventObj;
         }
-        return val;
+        scriptStore::shared().clear();
     }
+
+    sort(seconds.begin(), seconds.end());
+    double megabytes = data.size() / (1024.0 * 1024.0);
+    double best = seconds.front(), median = seconds[seconds.size() / 2];
+    cout << fixed << setprecision(3) << "ingest: " << megabytes << " MB, " << rows << " rows, " << runs << " runs, best " << best << " s ("
+         << megabytes / best << " MB/s), median " << median << " s (" << megabytes / median << " MB/s)" << endl;
+    cout.unsetf(ios::fixed);
+    return EXIT_SUCCESS;
 }
 
 
 
-void readFile(vector<event*> &allSpeeches){
+bool readFile(vector<event*> &allSpeeches, timeline &seasons, ingestBudget &budget){
     ifstream transcriptFile;
-    string fileName = "debate_transcripts_v3_2020-02-26.csv";
-
-    string line;
-
     //open transcript file
-    transcriptFile.open(fileName);
+    transcriptFile.open(TRANSCRIPT_FILE, ios::binary);
     if (!transcriptFile.is_open()){
         cout << "Failed to open file." << endl;
-        exit(EXIT_FAILURE);
+        return false;
     }
 
-    //move past the label line
-    getline(transcriptFile, line);
-    line.clear();
-
-
-    int lineNumber = 1;
-    int lineOfFile = 1;
-    string date = "";
-    string prevDate = "";
-    string eventName, section, speaker, script = "";
-    float length = 0.0;
+    csvStats stats;
 
-    size_t pos = 0;
+    //speaker spelling variants; the table is optional
+    int aliasCount = aliasResolver::shared().loadFile(ALIAS_FILE);
+    if (aliasCount >= 0){
+        cout << "Loaded " << aliasCount << " speaker aliases. ";
+    }
 
-    event* eventObj;
+    //candidates and moderators; unlisted speakers are classified by their turns
+    int roleCount = roleModel::shared().loadFile(ROLE_FILE);
+    if (roleCount >= 0){
+        cout << "Loaded " << roleCount << " speaker roles. ";
+    }
 
     cout << "Reading in events from file. ";
 
-    //read through entire file
-    while (!transcriptFile.eof()){
-        pos = 0;
-        line.clear();
-        lineOfFile++;
-
-        getline(transcriptFile, line);
-
-        // get the date
-        date = nextCSV(line, pos);
-        // cout << date << endl;
-        if (date == "Failure"){
-            printf("Bad Date: Line #%d of file.\n", lineOfFile);
-            continue;
-        }
-
-        pos++;
-        //get the event name
-        eventName = nextCSV(line, pos);
-        // cout << eventName << endl;
-        if (eventName == "Failure"){
-            printf("Bad Event: Line #%d of file.\n", lineOfFile);
-            continue;
-        }
+    ingestTranscripts(transcriptFile, allSpeeches, stats, 1 << 16, &seasons, &budget);
 
-        pos++;
-        //get the section
-        section = nextCSV(line, pos);
-        // cout << section << endl;
-        if (section == "Failure"){
-            printf("Bad Section: Line #%d of file.\n", lineOfFile);
-            continue;
-        }
-        
-        pos++;
-        //get the speaker name
-        speaker = nextCSV(line, pos);
-        // cout << speaker << endl;
-        if (eventName == "Failure"){
-            printf("Bad Speaker: Line #%d of file.\n", lineOfFile);
-            continue;
-        }
-
-        pos++;
-        //get the transcript
-        script = nextCSV(line, pos);
-        // cout << script << endl;
-        if (eventName == "Failure"){
-            printf("Bad Script: Line #%d of file.\n", lineOfFile);
-            continue;
-        }
+    cout << "Finished Reading File. " << endl;
 
-        //get the speaking length
-        length = getLength(line, pos);
-        // cout << length << endl;
-        if (length == -1){
-            printf("Bad Length: Line #%d of file.\n", lineOfFile);
-            continue;
+    //summarize problem rows
+    if (stats.rejected > 0){
+        cout << stats.rejected << " of " << stats.records << " rows skipped." << endl;
+    }
+    for (int i = 0; i < CSV_REASON_COUNT; i++){
+        if (stats.reasons[i] > 0 && csvStats::isRejection(i)){
+            cout << "\t" << setw(20) << left << csvStats::reasonName(i) << " | " << stats.reasons[i] << endl;
         }
+    }
 
-        
-        //if line is from a new event, create a new event object
-        if (date != prevDate){
-            lineNumber = 1; //reset line number
-            prevDate = date;
-
-            //create new event object
-            eventObj = new event(eventName, date);
-            allSpeeches.emplace_back(eventObj);
+    //lexicon scores, read back if this file and these lexicons were scored before
+    lexiconSet& lexicons = lexiconSet::shared();
+    if (lexicons.loadDirectory(LEXICON_DIR) > 0){
+        if (lexicons.getRejectedLines() > 0)
+            cout << lexicons.getRejectedLines() << " lexicon lines skipped for a malformed weight." << endl;
+        if (!budget.degraded() && readScoreCache(SCORE_CACHE, allSpeeches, lexicons)){
+            cout << "Loaded scores for " << lexicons.getCount() << " lexicons from " << SCORE_CACHE << "." << endl;
         }
         else{
-            lineNumber++;
+            auto start = chrono::steady_clock::now();
+            scoreEvents(allSpeeches, lexicons);
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            cout << "Scored speeches with " << lexicons.getCount() << " lexicons in " << fixed << setprecision(2) << elapsed.count() << " seconds." << endl;
+            cout.unsetf(ios::fixed);
+            cout << setprecision(6);
+
+            //scores of a degraded read would hide the full ones on the next run
+            if (!budget.degraded()){
+                writeScoreCache(SCORE_CACHE, allSpeeches, lexicons);
+            }
         }
+    }
 
-        //add new speech object to event object
-        eventObj->addSpeech(speech(lineNumber, speaker, script, length));
-
-    }//end while
-
-    cout << "Finished Reading File. " << endl;
+    //summarize what the budget cost
+    if (budget.limitHitAt > 0){
+        cout << "Memory budget of " << budget.maxBytes / 1024 << " KB reached at " << budget.limitHitAt / 1024 << " KB; peak "
+             << budget.peakBytes / 1024 << " KB." << endl;
+    }
+    if (budget.spilled){
+        cout << "\tScript text was moved to a temporary file; phrase search reads it back from disk." << endl;
+    }
+    if (budget.dropped){
+        cout << "\tScript text of later rows was dropped; phrase search and vocabulary comparison miss those rows." << endl;
+    }
+    if (budget.sampleStride > 1){
+        cout << "\tKept 1 in " << budget.sampleStride << " rows at most; " << budget.sampledOut
+             << " rows skipped, so totals for later events are a sample." << endl;
+    }
+    if (budget.timedOut){
+        cout << "Time budget of " << budget.maxSeconds << " seconds reached; stopped after " << budget.bytesRead / 1024
+             << " KB of input and kept " << allSpeeches.size() << " events." << endl;
+    }
 
+    return true;
 }//end readFile
 
 
 
 void printEvents(vector<event*> &allSpeeches){
-    cout << endl << "===================================================================" << endl;
-    cout << "\tAll Events: " << endl;
-    cout << "===================================================================" << endl;
-    for (int i = 0; i < allSpeeches.size(); i++){
-        cout << setw(3) << right << i + 1 << "| ";
-        cout << setw(40) << left << allSpeeches[i]->getName() << " | ";
-        cout << setw(11) << left << allSpeeches[i]->getDate() << " | ";
-        cout << setw(3) << left << allSpeeches[i]->getSpeakerCount() << endl;
-    }
-    cout << endl;
+    string header = "\n===================================================================\n";
+    header += "\tAll Events: \n";
+    header += "===================================================================\n";
+    appendf(header, "   | %-40s | %-11s | %-8s | %s\n", "Event", "Date", "SPEAKERS", "CANDIDATES");
+
+    pager table;
+    table.setTable(header, allSpeeches.size(), [&](string& buffer, int i){
+        appendf(buffer, "%3d| %-40s | %-11s | %-8d | %d\n", i + 1, allSpeeches[i]->getName().c_str(), allSpeeches[i]->getDate().c_str(),
+                allSpeeches[i]->getSpeakerCount(), allSpeeches[i]->getRoleCount(ROLE_CANDIDATE));
+    });
+    table.browse(cin);
 }
 
 
 
 void eventsMenu(vector<event*> &allSpeeches){
+    static eventComparer comparer;
 
     printEvents(allSpeeches);
     cout << endl;
@@ -332,11 +536,17 @@ void eventsMenu(vector<event*> &allSpeeches){
         cout << "\tA) Sort by Name" << endl;
         cout << "\tB) Sort by Date" << endl;
         cout << "\tC) Sort by Number of Speakers" << endl;
+        cout << "\tD) Compare Events" << endl;
+        cout << "\tE) View Most Similar Events" << endl;
+        cout << "\tF) Sort by Number of Candidates" << endl;
         cout << "\t#) View Event Details" << endl;
         cout << "\tX) Go Back" << endl;
         cout << endl << "\t>>";
 
-        cin >> choice;
+        //end of input leaves the menu
+        if (!(cin >> choice)){
+            return;
+        }
         cin.ignore();
         cout << endl << endl;
 
@@ -352,6 +562,38 @@ void eventsMenu(vector<event*> &allSpeeches){
             sort(allSpeeches.begin(), allSpeeches.end(), event::sortEventAttendance());
             printEvents(allSpeeches);
         }
+        else if (choice == "F" || choice == "f"){ //number of candidates
+            sort(allSpeeches.begin(), allSpeeches.end(), event::sortEventCandidates());
+            printEvents(allSpeeches);
+        }
+        else if (choice == "D" || choice == "d" || choice == "E" || choice == "e"){ //compare
+            if (comparer.getEventCount() != (int)allSpeeches.size()){
+                comparer.build(allSpeeches);
+            }
+
+            if (choice == "E" || choice == "e"){
+                printSimilarEvents(allSpeeches, comparer);
+                continue;
+            }
+
+            string line;
+            cout << "Event numbers to compare, separated by spaces: ";
+            getline(cin, line);
+
+            vector<event*> selected;
+            istringstream numbers(line);
+            int number;
+            while (numbers >> number){
+                if (number >= 1 && number <= (int)allSpeeches.size()){
+                    selected.push_back(allSpeeches[number - 1]);
+                }
+            }
+            if (selected.size() < 2){
+                cout << "Choose at least two events." << endl;
+                continue;
+            }
+            compareEvents(selected, comparer);
+        }
         else if (choice == "X" || choice == "x"){
             break;
         }
@@ -378,6 +620,135 @@ void eventsMenu(vector<event*> &allSpeeches){
 
 
 
+void compareEvents(vector<event*> &selected, const eventComparer &comparer){
+    aliasResolver& aliases = aliasResolver::shared();
+    vector<int> rows;
+    for (event* e : selected){
+        rows.push_back(comparer.indexOf(e));
+    }
+
+    //speakers in any selected event, by largest share
+    vector<int> ids;
+    vector<float> largest(comparer.getSpeakerCount(), 0.0);
+    for (size_t id = 0; id < comparer.getSpeakerCount(); id++){
+        bool spoke = false;
+        for (int row : rows){
+            largest[id] = max(largest[id], comparer.getShare(row)[id]);
+            spoke = spoke || comparer.getTurns(row)[id] > 0;
+        }
+        if (spoke){
+            ids.push_back(id);
+        }
+    }
+    stable_sort(ids.begin(), ids.end(), [&](int a, int b){ return largest[a] > largest[b]; });
+
+    string header = "\n===================================================================\n";
+    header += "\tComparing Events\n";
+    header += "===================================================================\n";
+    for (size_t e = 0; e < selected.size(); e++){
+        appendf(header, "\t%c) %s : %s\n", (char)('A' + e), selected[e]->getName().c_str(), selected[e]->getDate().c_str());
+    }
+    appendf(header, "\n%-22s", "SPEAKER");
+    for (size_t e = 0; e < selected.size(); e++){
+        appendf(header, "| %c: WORDS  TIME   TURNS SHARE  ", (char)('A' + e));
+        if (e > 0){
+            appendf(header, "CHANGE ");
+        }
+    }
+    header += "\n";
+
+    pager table;
+    table.setTable(header, ids.size(), [&](string& buffer, int i){
+        int id = ids[i];
+        appendf(buffer, "%-22.22s", aliases.getName(id).c_str());
+        for (size_t e = 0; e < rows.size(); e++){
+            int row = rows[e];
+            if (comparer.getTurns(row)[id] > 0){
+                appendf(buffer, "|    %-6.0f %-6.0f %-5.0f %5.1f%% ", comparer.getWords(row)[id], comparer.getTime(row)[id],
+                        comparer.getTurns(row)[id], 100 * comparer.getShare(row)[id]);
+            }
+            else{
+                appendf(buffer, "|    %-6s %-6s %-5s %6s ", "-", "-", "-", "-");
+            }
+            if (e > 0){
+                appendf(buffer, "%+6.1f ", 100 * (comparer.getShare(row)[id] - comparer.getShare(rows[0])[id]));
+            }
+        }
+        buffer += "\n";
+    });
+    table.browse(cin);
+
+    //similarity of each pair
+    cout << endl << setw(8) << left << "PAIR" << " | " << setw(15) << "SPEAKER COSINE" << " | " << setw(15) << "SPEAKER JS"
+         << " | " << setw(15) << "VOCAB COSINE" << " | " << "VOCAB JS" << endl;
+    cout << fixed << setprecision(3);
+    for (size_t a = 0; a < rows.size(); a++){
+        for (size_t b = a + 1; b < rows.size(); b++){
+            similarity pair = comparer.compare(rows[a], rows[b]);
+            string name = string(1, 'A' + a) + "-" + string(1, 'A' + b);
+            cout << setw(8) << left << name << " | " << setw(15) << pair.speakerCosine << " | " << setw(15) << pair.speakerJS
+                 << " | " << setw(15) << pair.vocabCosine << " | " << pair.vocabJS << endl;
+        }
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6) << endl;
+}
+
+
+
+void printSimilarEvents(vector<event*> &allSpeeches, const eventComparer &comparer){
+    const int nearest = 3; //events listed per metric
+    int n = allSpeeches.size();
+    vector<int> rows;
+    for (event* e : allSpeeches){
+        rows.push_back(comparer.indexOf(e));
+    }
+
+    vector<float> speakers = comparer.matrix(SPEAKER_COSINE);
+    vector<float> vocabulary = comparer.matrix(VOCAB_JS);
+    size_t stride = comparer.getEventCount();
+
+    //appends the events closest to event a: highest similarity, or lowest divergence
+    auto appendClosest = [&](string& buffer, const vector<float>& values, int a, bool higher){
+        vector<int> others;
+        for (int b = 0; b < n; b++){
+            if (b != a)
+                others.push_back(b);
+        }
+        int count = min(nearest, (int)others.size());
+        partial_sort(others.begin(), others.begin() + count, others.end(), [&](int x, int y){
+            float valueX = values[rows[a] * stride + rows[x]], valueY = values[rows[a] * stride + rows[y]];
+            return higher ? valueX > valueY : valueX < valueY;
+        });
+        for (int i = 0; i < nearest; i++){
+            if (i < count)
+                appendf(buffer, " %3d %5.3f", others[i] + 1, values[rows[a] * stride + rows[others[i]]]);
+            else
+                appendf(buffer, " %9s", "");
+        }
+    };
+
+    string header = "\n===================================================================\n";
+    header += "\tMost Similar Events\n";
+    header += "===================================================================\n";
+    header += "Speaker share cosine similarity: 1 = same mix of speakers\n";
+    header += "Vocabulary Jensen-Shannon divergence: 0 = same word frequencies\n\n";
+    appendf(header, "%3s | %-35s | %-30s | %s\n", "#", "EVENT", "SPEAKERS (COSINE)", "VOCABULARY (JS)");
+
+    pager table;
+    table.setTable(header, n, [&](string& buffer, int a){
+        appendf(buffer, "%3d | %-35.35s |", a + 1, allSpeeches[a]->getName().c_str());
+        appendClosest(buffer, speakers, a, true);
+        buffer += " |";
+        appendClosest(buffer, vocabulary, a, false);
+        buffer += "\n";
+    });
+    table.browse(cin);
+    cout << endl << "Numbers are event numbers in the current listing." << endl << endl;
+}
+
+
+
 void eventDetails(event* eventToStat){
 
     //print event stats
@@ -386,7 +757,38 @@ void eventDetails(event* eventToStat){
     cout << setw(25) << left << "Total Word Count" << left << " | " << setw(5) << eventToStat->getWordCount() << endl;
     cout << setw(25) << left << "Average Word Count" << left << " | " << setw(5) << eventToStat->getWordCount() / eventToStat->getSpeechCount() << endl;
     cout << setw(25) << left << "Total Speaking Time" << left << " | " << setw(5) << eventToStat->getTotalTime() << endl;
-    cout << setw(25) << left << "Average Speaking Time" << left << " | " << setw(5) << eventToStat->getTotalTime() / eventToStat->getSpeechCount() << endl;
+    cout << setw(25) << left << "Average Speaking Time" << left << " | " << setw(5) << fixed << setprecision(1) << eventToStat->getTotalTime() / eventToStat->getSpeechCount() << endl;
+    paceTotals pace = eventToStat->getPace();
+    cout << setw(25) << left << "Words Per Minute" << left << " | " << setw(5) << pace.wordsPerMinute() << endl;
+    cout << setw(25) << left << "Flagged Turns" << left << " | " << pace.flagged << " of " << pace.turns << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    const turnDistribution& turns = eventToStat->getTurns();
+    cout << setw(25) << left << "WC Median/P90/P99/Max" << left << " | " << turns.words.quantile(0.5) << " / " << turns.words.quantile(0.9)
+         << " / " << turns.words.quantile(0.99) << " / " << turns.words.getMax() << endl;
+    cout << setw(25) << left << "Time Median/P90/P99/Max" << left << " | " << turns.time.quantile(0.5) << " / " << turns.time.quantile(0.9)
+         << " / " << turns.time.quantile(0.99) << " / " << turns.time.getMax() << endl;
+
+    //the same averages within each role, so moderator turns don't skew the candidates'
+    for (int role = ROLE_CANDIDATE; role < ROLE_COUNT; role++){
+        const roleTotals& totals = eventToStat->getRoleTotals(role);
+        if (totals.turns == 0)
+            continue;
+        cout << setw(25) << left << string(roleModel::roleName(role)) + "s" << left << " | " << totals.speakers << " speakers, "
+             << totals.turns << " turns, " << totals.words / totals.turns << " avg WC, " << fixed << setprecision(1)
+             << totals.time / totals.turns << " avg time" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+
+    //lexicon scores per 1000 words
+    const vector<float>& scores = eventToStat->getScores();
+    for (size_t l = 0; l < scores.size(); l++){
+        cout << setw(25) << left << "Lexicon: " + lexiconSet::shared().getName(l) << left << " | " << showpos << fixed << setprecision(1)
+             << (eventToStat->getWordCount() > 0 ? 1000.0 * scores[l] / eventToStat->getWordCount() : 0.0) << noshowpos << " per 1000 words" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
     cout << "===================================================================" << endl;
    
 
@@ -398,6 +800,10 @@ void eventDetails(event* eventToStat){
         speakers.push_back({it->first, it->second});
     }
 
+    //display order; sorting moves indexes instead of speaker stats
+    vector<int> order(speakers.size());
+    iota(order.begin(), order.end(), 0);
+
     //display sort menu
     char choice = 'Z';
     while (choice != 'X'){
@@ -407,34 +813,55 @@ void eventDetails(event* eventToStat){
         cout << "\tC) Sort by Average Word Count" << endl;
         cout << "\tD) Sort by Longest Speaking Time" << endl;
         cout << "\tE) Sort by Average Speaking Time" << endl;
+        cout << "\tF) View Turn Distributions" << endl;
+        cout << "\tG) Sort by Speaking Rate" << endl;
+        cout << "\tH) View Speaking Rate by Section" << endl;
+        cout << "\tR) Filter by Role" << endl;
         cout << "\tX) Go Back" << endl;
         cout << endl << "\t>>";
 
-        cin >> choice;
+        //end of input leaves the menu
+        if (!(cin >> choice)){
+            return;
+        }
         cin.ignore();
         cout << endl;
         choice = toupper(choice);
        
         switch (choice){
             case 'A': //Name
-                sort(speakers.begin(), speakers.end(), event::sortSpeakersName());
-                printEventAttendeesStats(speakers, eventToStat->getName(), 0);
+                sortOrder(order, speakers, event::sortSpeakersName());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
                 break;
             case 'B': //High WC
-                sort(speakers.begin(), speakers.end(), event::sortSpeakersHighWC());
-                printEventAttendeesStats(speakers, eventToStat->getName(), 0);
+                sortOrder(order, speakers, event::sortSpeakersHighWC());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
                 break;
             case 'C': //AVG WC
-                sort(speakers.begin(), speakers.end(), event::sortSpeakersAvgWC());
-                printEventAttendeesStats(speakers, eventToStat->getName(), 0);
+                sortOrder(order, speakers, event::sortSpeakersAvgWC());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
                 break;
             case 'D': //High Time
-                sort(speakers.begin(), speakers.end(), event::sortSpeakersHighTime());
-                printEventAttendeesStats(speakers, eventToStat->getName(), 0);
+                sortOrder(order, speakers, event::sortSpeakersHighTime());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
                 break;
             case 'E': //AVG Time
-                sort(speakers.begin(), speakers.end(), event::sortSpeakersAvgTime());
-                printEventAttendeesStats(speakers, eventToStat->getName(), 0);
+                sortOrder(order, speakers, event::sortSpeakersAvgTime());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
+                break;
+            case 'F': //Distributions
+                printTurnDistributions(speakers, order, eventToStat->getName(), eventToStat->getTurns());
+                break;
+            case 'G': //Pace
+                sortOrder(order, speakers, event::sortSpeakersPace());
+                printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
+                break;
+            case 'H': //Sections
+                printSectionPace(eventToStat);
+                break;
+            case 'R': //Role
+                if (filterByRole(order, speakers))
+                    printEventAttendeesStats(speakers, order, eventToStat->getName(), 0);
                 break;
             case 'X': //Exit
                 break;
@@ -450,71 +877,402 @@ void eventDetails(event* eventToStat){
 
 
 
-//presorted
-void printEventAttendeesStats(vector<pair <string, speakerStats> > &speakers, string name, int mode){
+void printEventAttendeesStats(vector<pair <string, speakerStats> > &speakers, vector<int> &order, string name, int mode){
     //heading
-
-    cout << endl << "===================================================================" << endl;
-    cout << "\t" << name << endl;
-    cout << "===================================================================" << endl;
-
-    cout << "    | " <<  setw(21) << left << "Speaker";
+    string header = "\n===================================================================\n";
+    header += "\t" + name + "\n";
+    header += "===================================================================\n";
+    appendf(header, "    | %-21s", "Speaker");
     if (mode == 1){
-        cout << "| #EVENTS";
+        header += "| #EVENTS";
     }
-    cout << "|   WC  " <<  "| AVG WC " << setw(6) << left << "| TOT TIME " << setw(10) << left <<"| AVG TIME " << endl;
+    header += "|   WC  | AVG WC | TOT TIME | AVG TIME | WPM   | FLAGGED | ROLE      ";
+
+    //lexicon scores per 1000 words
+    const lexiconSet& lexicons = lexiconSet::shared();
+    for (int l = 0; l < lexicons.getCount(); l++){
+        string title = lexicons.getName(l);
+        transform(title.begin(), title.end(), title.begin(), ::toupper);
+        appendf(header, "| %-8.8s ", title.c_str());
+    }
+    header += "\n";
 
-    //print all speakers' stats
-    for (int i = 0; i < speakers.size(); i++){
-        string name = speakers[i].first;
-        speakerStats stats = speakers[i].second;
+    //format only the rows on screen
+    pager table;
+    table.setTable(header, order.size(), [&](string& buffer, int i){
+        const string& speakerName = speakers[order[i]].first;
+        const speakerStats& stats = speakers[order[i]].second;
 
         //number + name
-        cout << setw(3) << left << i + 1 << " | " << setw(20) << left << name << " | ";
+        appendf(buffer, "%-3d | %-20s | ", i + 1, speakerName.c_str());
 
         //#appearances if mode 1
         if (mode == 1){
-            cout << setw(6) << left << speakers[i].second.appearances << " | ";
+            appendf(buffer, "%-6d | ", stats.appearances);
+        }
+
+        //total/average WC, total/average speaking time, speaking rate
+        appendf(buffer, "%-5d | %-6.1f | %-8.1f | %-8.1f | %-5.1f | %-7d | %-9s ", stats.totalWordCount, (double)stats.totalWordCount / stats.timesSpoke,
+                stats.totalSpeakingTime, stats.totalSpeakingTime / stats.timesSpoke, stats.pace.wordsPerMinute(), stats.pace.flagged,
+                roleModel::roleName(stats.role));
+        for (size_t l = 0; l < stats.scores.size(); l++){
+            appendf(buffer, "| %-+8.1f ", stats.totalWordCount > 0 ? 1000.0 * stats.scores[l] / stats.totalWordCount : 0.0);
         }
+        buffer += "\n";
+    });
+    table.browse(cin);
+}
+
+
+
+void printTurnDistributions(vector<pair <string, speakerStats> > &speakers, vector<int> &order, string name, const turnDistribution &overall){
+    string header = "\n===================================================================\n";
+    header += "\t" + name + ": Turn Distributions\n";
+    header += "===================================================================\n";
+    appendf(header, "    | %-21s| TURNS | WC MED/P90/P99/MAX      | TIME MED/P90/P99/MAX\n", "Speaker");
+
+    pager table;
+    table.setTable(header, order.size(), [&](string& buffer, int i){
+        const turnDistribution& turns = speakers[order[i]].second.turns;
+
+        char wc[64], time[64];
+        snprintf(wc, sizeof(wc), "%d/%d/%d/%d", (int)turns.words.quantile(0.5), (int)turns.words.quantile(0.9),
+                 (int)turns.words.quantile(0.99), (int)turns.words.getMax());
+        snprintf(time, sizeof(time), "%d/%d/%d/%d", (int)turns.time.quantile(0.5), (int)turns.time.quantile(0.9),
+                 (int)turns.time.quantile(0.99), (int)turns.time.getMax());
+
+        appendf(buffer, "%-3d | %-20s | %-5ld | %-23s | %s\n", i + 1, speakers[order[i]].first.c_str(), turns.words.getCount(), wc, time);
+    });
+    table.browse(cin);
+
+    //histograms of every turn
+    string histogram;
+    appendf(histogram, "%-12s| %-8s| TIME\n", "Bucket", "WC");
+    for (int b = 0; b < logHistogram::BUCKETS; b++){
+        string label = (b == logHistogram::BUCKETS - 1) ? to_string((int)logHistogram::bucketLow(b)) + "+"
+                     : to_string((int)logHistogram::bucketLow(b)) + "-" + to_string((int)logHistogram::bucketLow(b + 1) - 1);
+        if (b == 0)
+            label = "<1";
+        appendf(histogram, "%-12s| %-8ld| %ld\n", label.c_str(), overall.wordHistogram.getBucket(b), overall.timeHistogram.getBucket(b));
+    }
+    histogram.push_back('\n');
+    cout.write(histogram.data(), histogram.size());
+    cout.flush();
+}
+
+
 
-        //total/average WC
-        cout << setw(5) << left <<  stats.totalWordCount << " | " << setw(6) << left << stats.totalWordCount / stats.timesSpoke << " | ";
-        //total/average speaking time
-        cout << setw(8) << setprecision(7) << left << stats.totalSpeakingTime << " | " << setw(7) << setprecision(7) << left << stats.totalSpeakingTime / stats.timesSpoke << endl;
+void printSectionPace(event* eventToStat){
+    const vector<string>& sections = eventToStat->getSections();
 
+    cout << endl << "===================================================================" << endl;
+    cout << "\t" << eventToStat->getName() << ": Speaking Rate by Section" << endl;
+    cout << "===================================================================" << endl;
+    cout << "    | " << setw(41) << left << "Section" << "| TURNS | WPM   | FLAGGED" << endl;
+
+    cout << fixed << setprecision(1);
+    for (size_t i = 0; i < sections.size(); i++){
+        paceTotals pace = eventToStat->getSectionPace(i);
+        cout << setw(3) << left << i + 1 << " | " << setw(40) << left << sections[i].substr(0, 40) << " | ";
+        cout << setw(5) << left << pace.turns << " | " << setw(5) << left << pace.wordsPerMinute() << " | " << pace.flagged << endl;
     }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
     cout << endl;
 }
 
 
 
-void speakerMenu(vector<event*> &allSpeeches){
+void printStorageStats(){
+    const scriptStoreStats& stats = scriptStore::shared().getStats();
+
+    cout << endl << "===================================================================" << endl;
+    cout << "\tScript Storage" << endl;
+    cout << "===================================================================" << endl;
+    cout << setw(25) << left << "Blocks" << " | " << scriptStore::shared().getBlockCount() << endl;
+    cout << setw(25) << left << "Raw Size (KB)" << " | " << stats.rawBytes / 1024 << endl;
+    cout << setw(25) << left << "Compressed Size (KB)" << " | " << stats.compressedBytes / 1024 << endl;
+    if (stats.rawBytes > 0){
+        cout << setw(25) << left << "Compression Ratio" << " | " << fixed << setprecision(1) << 100.0 * stats.compressedBytes / stats.rawBytes << "%" << endl;
+    }
+    if (stats.spilledBytes > 0){
+        cout << setw(25) << left << "Spilled to Disk (KB)" << " | " << stats.spilledBytes / 1024 << endl;
+    }
+    if (stats.droppedBytes > 0){
+        cout << setw(25) << left << "Dropped (KB)" << " | " << stats.droppedBytes / 1024 << endl;
+    }
+    cout << setw(25) << left << "Cache Hits / Misses" << " | " << stats.cacheHits << " / " << stats.cacheMisses << endl;
+    if (stats.decompressSeconds > 0){
+        cout << setw(25) << left << "Decompression (MB/s)" << " | " << fixed << setprecision(1) << stats.decompressedBytes / stats.decompressSeconds / (1024 * 1024) << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << endl;
+}
+
+
+
+void exportData(vector<event*> &allSpeeches){
+    string fileName, choice;
+
+    //drop the rest of the menu line
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    cout << "Export file name: ";
+    getline(cin, fileName);
+    if (fileName.empty()){
+        cout << "Export cancelled." << endl;
+        return;
+    }
+    cout << "Include speech text? (Y/N): ";
+    getline(cin, choice);
+
+    shared_ptr<exportSet> data = exportSet::build(allSpeeches, choice == "Y" || choice == "y");
+    if (!data->write(fileName)){
+        cout << "Unable to write " << fileName << endl;
+        return;
+    }
+
+    cout << endl << "Wrote " << fileName << ":" << endl;
+    for (auto& tbl : data->getTables()){
+        cout << "\t" << setw(15) << left << tbl.name << tbl.rows << " rows, " << tbl.columns.size() << " columns" << endl;
+    }
+}
+
+
+
+void printAliasSuggestions(){
+    aliasResolver& aliases = aliasResolver::shared();
+    vector<aliasSuggestion> suggestions = aliases.suggest();
+
+    cout << endl << "===================================================================" << endl;
+    cout << "\tPossible Speaker Aliases" << endl;
+    cout << "===================================================================" << endl;
+    if (suggestions.empty()){
+        cout << "No likely aliases found." << endl << endl;
+        return;
+    }
+
+    cout << setw(22) << left << "NAME" << " | " << setw(6) << "TURNS" << " | " << setw(22) << "PROBABLY" << " | " << "TURNS" << endl;
+    for (auto& suggestion : suggestions){
+        cout << setw(22) << left << aliases.getName(suggestion.variant) << " | " << setw(6) << aliases.getUses(suggestion.variant) << " | "
+             << setw(22) << aliases.getName(suggestion.canonical) << " | " << aliases.getUses(suggestion.canonical) << endl;
+    }
+    cout << endl << "Add \"name = canonical name\" lines to " << ALIAS_FILE << " to merge them." << endl << endl;
+}
+
+
+
+void concordanceMenu(vector<event*> &allSpeeches, const ingestBudget &budget){
+    const int width = 30; //characters of context on each side
+
+    //the index counts against the memory budget along with everything ingest kept
+    if (budget.maxBytes > 0){
+        size_t held = scriptStore::shared().memoryBytes();
+        for (event* eventObj : allSpeeches){
+            held += eventObj->memoryBytes();
+        }
+        size_t needed = scriptStore::shared().getStats().rawBytes * concordance::BUILD_BYTES_PER_CHAR;
+        if (held + needed > budget.maxBytes){
+            cout << "The phrase index needs about " << needed / 1024 << " KB, more than the memory budget leaves." << endl;
+            return;
+        }
+    }
+
+    concordance index;
+    cout << "Indexing scripts. ";
+    index.build(allSpeeches);
+    cout << "Indexed " << index.getLength() / 1024 << " KB in " << fixed << setprecision(2) << index.getBuildSeconds() << " seconds, holding "
+         << index.memoryBytes() / 1024 << " KB until this menu is closed." << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+
+    string choice = " ";
+    while ((choice != "X") && (choice != "x")){
+        cout << endl << "===================================================================" << endl;
+        cout << "\tKeyword in Context" << endl;
+        cout << "===================================================================" << endl;
+        cout << "\tA) Search for a Phrase" << endl;
+        cout << "\tB) Export Phrases From a File" << endl;
+        cout << "\tX) Go Back" << endl;
+        cout << endl << "\t>>";
+
+        //end of input leaves the menu
+        if (!(cin >> choice)){
+            return;
+        }
+        cin.ignore();
+        cout << endl;
+
+        if (choice == "A" || choice == "a"){ //search
+            string phrase;
+            cout << "Phrase: ";
+            getline(cin, phrase);
+            if (phrase.empty())
+                continue;
+
+            vector<kwicLine> lines = index.search(phrase, width);
+
+            string header = "\n===================================================================\n";
+            header += "\t\"" + phrase + "\": " + to_string(lines.size()) + " occurrences\n";
+            header += "===================================================================\n";
+
+            pager table;
+            table.setTable(header, lines.size(), [&](string& buffer, int i){
+                const kwicLine& line = lines[i];
+                //speaker and date only at the start of each group
+                bool newGroup = i == 0 || line.speaker != lines[i - 1].speaker || line.date != lines[i - 1].date;
+                if (newGroup || i % 25 == 0)
+                    appendf(buffer, "%s, %s\n", line.speaker.c_str(), line.date.c_str());
+                appendf(buffer, "  %4d| %*s [%s] %s\n", line.position, width, line.left.c_str(), line.match.c_str(), line.right.c_str());
+            });
+            table.browse(cin);
+        }
+        else if (choice == "B" || choice == "b"){ //batch export
+            string inName, outName;
+            cout << "Phrase file (one phrase per line): ";
+            getline(cin, inName);
+            ifstream phrases(inName);
+            if (!phrases.is_open()){
+                cout << "Unable to open " << inName << endl;
+                continue;
+            }
+            cout << "Output file: ";
+            getline(cin, outName);
+            ofstream out(outName);
+            if (!out.is_open()){
+                cout << "Unable to write " << outName << endl;
+                continue;
+            }
+
+            int rows = index.exportTsv(phrases, out, width);
+            cout << "Wrote " << rows << " rows to " << outName << endl;
+        }
+        else if (choice == "X" || choice == "x"){
+            return;
+        }
+        else{
+            cout << "Invalid Option" << endl;
+        }
+    }
+}
+
+
+
+bool filterByRole(vector<int> &order, vector<pair <string, speakerStats> > &speakers){
+    char choice = ' ';
+    cout << "Role (A = All, C = Candidates, M = Moderators, O = Other): ";
+    cin >> choice;
+    cin.ignore();
+
+    int role;
+    switch (toupper(choice)){
+        case 'A': role = ROLE_UNKNOWN; break;
+        case 'C': role = ROLE_CANDIDATE; break;
+        case 'M': role = ROLE_MODERATOR; break;
+        case 'O': role = ROLE_OTHER; break;
+        default:
+            cout << "Invalid Option." << endl;
+            return false;
+    }
+
+    //speakers are stored in name order, so the filtered order is too
+    order.clear();
+    for (int i = 0; i < (int)speakers.size(); i++){
+        if (role == ROLE_UNKNOWN || speakers[i].second.role == role){
+            order.push_back(i);
+        }
+    }
+    return true;
+}
+
+
+
+void speakerDetails(const string &name, int speakerId, const timeline &seasons){
+    const speakerSeries* rows = seasons.getSeries(speakerId);
+    if (!rows){
+        cout << "No timeline for " << name << endl;
+        return;
+    }
+
+    string header = "\n===================================================================\n";
+    header += "\t" + name + ": Season Timeline\n";
+    header += "===================================================================\n";
+    appendf(header, "%-11s| %-35s| %-6s| %-7s| %-5s| %-6s| %-7s| %s\n", "DATE", "EVENT", "WORDS", "TIME", "TURNS", "SHARE", "CHANGE", "RANK");
+
+    pager table;
+    table.setTable(header, rows->size(), [&](string& buffer, int i){
+        int slot = rows->slot[i];
+        char change[16] = "";
+        if (i > 0)
+            snprintf(change, sizeof(change), "%+.1f", seasons.delta(speakerId, i));
+        appendf(buffer, "%-11s| %-35.35s| %-6d| %-7.1f| %-5d| %5.1f%%| %-7s| %d/%d\n", seasons.getDate(slot).c_str(), seasons.getName(slot).c_str(),
+                rows->words[i], rows->time[i], rows->turns[i], rows->share[i], change, rows->rank[i], seasons.getSpeakerCount(slot));
+    });
+    table.browse(cin);
+
+    //rank in every event, blank where absent
+    cout << endl << "Rank history: ";
+    for (int rank : seasons.rankHistory(speakerId)){
+        cout << (rank > 0 ? to_string(rank) : "-") << " ";
+    }
+    cout << endl << "Trend: " << showpos << fixed << setprecision(2) << seasons.trend(speakerId) << noshowpos
+         << " points of speaking time share per event" << endl << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+
+
+void speakerMenu(vector<event*> &allSpeeches, const timeline &seasons){
     map<string, speakerStats> allSpeakers; //map to store info on all speakers
-    map<string, speakerStats> tempSpeakers; //temp map for .getSpeakers() return value
+    turnDistribution allTurns; //every turn of every event
+    map<string, int> roleTurns; //turns in the event each speaker's role was taken from
 
     //get total stats from all speakers
 
     //loop through each event
-    for (int i = 0; i < allSpeeches.size(); i++){
-        tempSpeakers = allSpeeches[i]->getSpeakers();
+    for (size_t i = 0; i < allSpeeches.size(); i++){
+        const map<string, speakerStats>& eventSpeakers = allSpeeches[i]->getSpeakers();
+        allTurns.merge(allSpeeches[i]->getTurns());
 
         //loop through each event's speakers
-        for (auto speaker = tempSpeakers.begin(); speaker != tempSpeakers.end(); speaker++){
-
-            //add new speaker to map
-            if (allSpeakers.count(speaker->first) == 0){
-                allSpeakers[speaker->first].appearances = 1;
-                allSpeakers[speaker->first].timesSpoke = speaker->second.timesSpoke;
-                allSpeakers[speaker->first].totalWordCount = speaker->second.totalWordCount;
-                allSpeakers[speaker->first].totalSpeakingTime = speaker->second.totalSpeakingTime;
+        for (auto speaker = eventSpeakers.begin(); speaker != eventSpeakers.end(); speaker++){
+            auto added = allSpeakers.try_emplace(speaker->first);
+            speakerStats& total = added.first->second;
+
+            //add new speaker
+            if (added.second){
+                total.appearances = 1;
+                total.speakerId = speaker->second.speakerId;
+                total.timesSpoke = speaker->second.timesSpoke;
+                total.totalWordCount = speaker->second.totalWordCount;
+                total.totalSpeakingTime = speaker->second.totalSpeakingTime;
+                total.turns = speaker->second.turns;
+                total.pace = speaker->second.pace;
+                total.scores = speaker->second.scores;
             }
 
             //update speaker
             else{
-                allSpeakers[speaker->first].appearances++;
-                allSpeakers[speaker->first].timesSpoke += speaker->second.timesSpoke;
-                allSpeakers[speaker->first].totalWordCount += speaker->second.totalWordCount;
-                allSpeakers[speaker->first].totalSpeakingTime += speaker->second.totalSpeakingTime;
+                total.appearances++;
+                total.timesSpoke += speaker->second.timesSpoke;
+                total.totalWordCount += speaker->second.totalWordCount;
+                total.totalSpeakingTime += speaker->second.totalSpeakingTime;
+                total.turns.merge(speaker->second.turns);
+                total.pace.merge(speaker->second.pace);
+
+                vector<float>& scores = total.scores;
+                scores.resize(max(scores.size(), speaker->second.scores.size()), 0.0);
+                for (size_t l = 0; l < speaker->second.scores.size(); l++){
+                    scores[l] += speaker->second.scores[l];
+                }
+            }
+
+            //a speaker's overall role is their role in the event where they spoke most
+            int& mostTurns = roleTurns[speaker->first];
+            if (speaker->second.timesSpoke > mostTurns){
+                mostTurns = speaker->second.timesSpoke;
+                total.role = speaker->second.role;
             }
         } //end speaker for
     } //end event for
@@ -526,6 +1284,9 @@ void speakerMenu(vector<event*> &allSpeeches){
         speakersVec.push_back({it->first, it->second});
     }
 
+    vector<int> order(speakersVec.size());
+    iota(order.begin(), order.end(), 0);
+
 
     //menu loop
     string choice = " ";
@@ -540,12 +1301,18 @@ void speakerMenu(vector<event*> &allSpeeches){
         cout << "\tD) Sort by Average Word Count" << endl;
         cout << "\tE) Sort by Highest Speaking Time" << endl;
         cout << "\tF) Sort by Average Speaking Time" << endl;
-        // cout << "\t#) View Speaker Details" << endl;
+        cout << "\tG) View Turn Distributions" << endl;
+        cout << "\tH) Sort by Speaking Rate" << endl;
+        cout << "\tI) View Possible Aliases" << endl;
+        cout << "\tR) Filter by Role" << endl;
+        cout << "\t#) View Speaker Details" << endl;
         cout << "\tX) Go Back" << endl;
         cout << endl << "\t>>";
 
-        //get choice
-        cin >> choice;
+        //get choice; end of input leaves the menu
+        if (!(cin >> choice)){
+            return;
+        }
         cin.ignore();
         cout << endl;
         // choice = toupper(choice);
@@ -553,41 +1320,71 @@ void speakerMenu(vector<event*> &allSpeeches){
         string name = "All Events";
 
         if (choice == "A" || choice == "a"){ //name
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersName());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersName());
+            printEventAttendeesStats(speakersVec, order, name, 1);
         }
         else if (choice == "B" || choice == "b"){ //attendance
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersAttendance());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersAttendance());
+            printEventAttendeesStats(speakersVec, order, name, 1);
         }
         else if (choice == "C" || choice == "c"){ //high word
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersHighWC());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersHighWC());
+            printEventAttendeesStats(speakersVec, order, name, 1);
         }
         else if (choice == "D" || choice == "d"){ //avg word
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersAvgWC());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersAvgWC());
+            printEventAttendeesStats(speakersVec, order, name, 1);
         }
         else if (choice == "E" || choice == "e"){ //high time
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersHighTime());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersHighTime());
+            printEventAttendeesStats(speakersVec, order, name, 1);
         }
         else if (choice == "F" || choice == "f"){ //avg time
-            sort(speakersVec.begin(), speakersVec.end(), event::sortSpeakersAvgTime());
-            printEventAttendeesStats(speakersVec, name, 1);
+            sortOrder(order, speakersVec, event::sortSpeakersAvgTime());
+            printEventAttendeesStats(speakersVec, order, name, 1);
+        }
+        else if (choice == "G" || choice == "g"){ //distributions
+            printTurnDistributions(speakersVec, order, name, allTurns);
+        }
+        else if (choice == "H" || choice == "h"){ //pace
+            sortOrder(order, speakersVec, event::sortSpeakersPace());
+            printEventAttendeesStats(speakersVec, order, name, 1);
+        }
+        else if (choice == "I" || choice == "i"){ //aliases
+            printAliasSuggestions();
+        }
+        else if (choice == "R" || choice == "r"){ //role
+            if (filterByRole(order, speakersVec)){
+                printEventAttendeesStats(speakersVec, order, name, 1);
+            }
         }
         else if (choice == "X" || choice == "x"){
             return;
         }
         else{
-            cout << "Invalid Option" << endl;
+            int opt = 0;
+            try{ //check if number
+               opt = stoi(choice);
+            }
+            catch(const std::exception& e){
+                cout << "Invalid Option" << endl;
+                continue;
+            }
+            opt--;
+            if ((opt >= 0) && (opt < (int)order.size())){ //rank in the last listing
+                const pair<string, speakerStats>& speaker = speakersVec[order[opt]];
+                speakerDetails(speaker.first, speaker.second.speakerId, seasons);
+            }
+            else{
+                cout << "Invalid Option" << endl;
+            }
         }
     }
 } //end speakerMenu
 
 
 
-void mainMenu(vector<event*> &allSpeeches){
+void mainMenu(vector<event*> &allSpeeches, timeline &seasons, const ingestBudget &budget){
 
     char opt = ' ';
     while (opt != 'X'){
@@ -598,12 +1395,18 @@ void mainMenu(vector<event*> &allSpeeches){
         cout << "===================================================================" << endl;
         cout << "\tA) View Events" << endl;
         cout << "\tB) View Speakers" << endl;
+        cout << "\tC) View Storage Statistics" << endl;
+        cout << "\tD) Export Data" << endl;
+        cout << "\tE) Search Phrases in Context" << endl;
         cout << "\tX) Exit" << endl << endl;
         cout << "\t>>";
 
-        //get choice
-        opt = getchar();
-        opt = toupper(opt);
+        //get choice; end of input exits
+        int input = getchar();
+        if (input == EOF){
+            return;
+        }
+        opt = toupper(input);
         cout << endl;
 
         //display chosen menu
@@ -612,10 +1415,19 @@ void mainMenu(vector<event*> &allSpeeches){
                 eventsMenu(allSpeeches);
                 break;
             case 'B':
-                speakerMenu(allSpeeches);
+                speakerMenu(allSpeeches, seasons);
+                break;
+            case 'C':
+                printStorageStats();
+                break;
+            case 'D':
+                exportData(allSpeeches);
+                break;
+            case 'E':
+                concordanceMenu(allSpeeches, budget);
                 break;
             case 'X':
-                exit(0);
+                return;
             default:
                 cout << "Invalid Option." << endl;
         }
@@ -0,0 +1,196 @@
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
+#include "pager.h"
+
+using namespace std;
+
+static const int DEFAULT_PAGE_SIZE = 25;
+
+//default constructor
+pager::pager(){
+    out = &cout;
+    rowCount = 0;
+    pageSize = DEFAULT_PAGE_SIZE;
+    page = 0;
+}
+
+//overloaded constructor
+pager::pager(ostream& outStream, int rowsPerPage){
+    out = &outStream;
+    rowCount = 0;
+    pageSize = rowsPerPage > 0 ? rowsPerPage : DEFAULT_PAGE_SIZE;
+    page = 0;
+}
+
+/************************************************************/
+// Function name: setTable
+// Description: Sets the table to page through and returns to the first page.
+// Parameters: const string& heading - text printed above the rows on every page
+//             int rows - number of rows
+//             rowFormatter formatter - appends one display row to the buffer
+// Return Value: none
+/************************************************************/
+void pager::setTable(const string& heading, int rows, rowFormatter formatter){
+    header = heading;
+    rowCount = rows;
+    formatRow = formatter;
+    page = 0;
+}
+
+/************************************************************/
+// Function name: render
+// Description: Formats the current page into the buffer and writes it in one call.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void pager::render(){
+    buffer.clear();
+    buffer.append(header);
+
+    int first = page * pageSize;
+    int last = min(rowCount, first + pageSize);
+    for (int i = first; i < last; i++)
+        formatRow(buffer, i);
+
+    if (getPageCount() > 1)
+        appendf(buffer, "\nPage %d of %d (rows %d-%d of %d)\n", page + 1, getPageCount(), first + 1, last, rowCount);
+    buffer.push_back('\n');
+
+    out->write(buffer.data(), buffer.size());
+    out->flush();
+}
+
+/************************************************************/
+// Function name: nextPage
+// Description: Moves to the next page if there is one.
+// Parameters: none
+// Return Value: bool - false if already on the last page
+/************************************************************/
+bool pager::nextPage(){
+    if (page + 1 >= getPageCount())
+        return false;
+    page++;
+    return true;
+}
+
+/************************************************************/
+// Function name: prevPage
+// Description: Moves to the previous page if there is one.
+// Parameters: none
+// Return Value: bool - false if already on the first page
+/************************************************************/
+bool pager::prevPage(){
+    if (page == 0)
+        return false;
+    page--;
+    return true;
+}
+
+/************************************************************/
+// Function name: jumpToRank
+// Description: Moves to the page holding a row.
+// Parameters: int rank - 1-based row number
+// Return Value: bool - false if the rank is out of range
+/************************************************************/
+bool pager::jumpToRank(int rank){
+    if (rank < 1 || rank > rowCount)
+        return false;
+    page = (rank - 1) / pageSize;
+    return true;
+}
+
+/************************************************************/
+// Function name: browse
+// Description: Renders the first page, then reads paging commands until the user is done.
+//              Tables that fit on one page are printed without a prompt.
+// Parameters: istream& in - command input
+// Return Value: none
+/************************************************************/
+void pager::browse(istream& in){
+    render();
+
+    string choice = " ";
+    while (getPageCount() > 1){
+        *out << "\tN) Next Page  P) Previous Page  #) Jump to Rank  X) Done" << endl << "\t>>";
+
+        if (!(in >> choice))
+            return;
+        in.ignore();
+
+        if (choice == "X" || choice == "x")
+            return;
+        else if (choice == "N" || choice == "n"){
+            if (!nextPage()){
+                *out << "Last page." << endl;
+                continue;
+            }
+        }
+        else if (choice == "P" || choice == "p"){
+            if (!prevPage()){
+                *out << "First page." << endl;
+                continue;
+            }
+        }
+        else{
+            int rank = 0;
+            if (sscanf(choice.c_str(), "%d", &rank) != 1 || !jumpToRank(rank)){
+                *out << "Invalid Option." << endl;
+                continue;
+            }
+        }
+        render();
+    }
+}
+
+/************************************************************/
+// Function name: getPage
+// Description: returns the current page
+// Parameters: none
+// Return Value: int - 0-based page number
+/************************************************************/
+int pager::getPage() const {return page;}
+
+/************************************************************/
+// Function name: getPageCount
+// Description: returns number of pages, at least 1
+// Parameters: none
+// Return Value: int - page count
+/************************************************************/
+int pager::getPageCount() const {return rowCount > 0 ? (rowCount + pageSize - 1) / pageSize : 1;}
+
+/************************************************************/
+// Function name: getBuffer
+// Description: returns the text of the last rendered page
+// Parameters: none
+// Return Value: const string& - page text
+/************************************************************/
+const string& pager::getBuffer() const {return buffer;}
+
+
+/************************************************************/
+// Function name: appendf
+// Description: printf-style formatting onto the end of a string, without a temporary stream.
+// Parameters: string& buffer - string to append to
+//             const char* format - printf format
+// Return Value: none
+/************************************************************/
+void appendf(string& buffer, const char* format, ...){
+    va_list args, copy;
+    va_start(args, format);
+    va_copy(copy, args);
+
+    size_t oldSize = buffer.size();
+    int length = vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+
+    if (length > 0){
+        buffer.resize(oldSize + length + 1);
+        vsnprintf(&buffer[oldSize], length + 1, format, args);
+        buffer.resize(oldSize + length);
+    }
+    va_end(args);
+}
@@ -0,0 +1,162 @@
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cctype>
+#include "roles.h"
+#include "aliases.h"
+
+using namespace std;
+
+//names that are never a candidate or a moderator
+static const char* OTHER_NAMES[] = {"audience", "crowd", "announcer", "voiceover", "male", "female"};
+
+/************************************************************/
+// Function name: shared
+// Description: returns the role model used by the application's ingest path
+// Parameters: none
+// Return Value: roleModel& - shared model
+/************************************************************/
+roleModel& roleModel::shared(){
+    static roleModel model;
+    return model;
+}
+
+/************************************************************/
+// Function name: roleName
+// Description: returns a role's display name
+// Parameters: int role - speakerRole
+// Return Value: const char* - name
+/************************************************************/
+const char* roleModel::roleName(int role){
+    switch (role){
+        case ROLE_CANDIDATE: return "Candidate";
+        case ROLE_MODERATOR: return "Moderator";
+        case ROLE_OTHER: return "Other";
+        default: return "Unknown";
+    }
+}
+
+/************************************************************/
+// Function name: parseRole
+// Description: reads a role name, ignoring case
+// Parameters: const string& name - "candidate", "moderator" or "other"
+// Return Value: int - speakerRole, ROLE_UNKNOWN if not recognized
+/************************************************************/
+int roleModel::parseRole(const string& name){
+    string key = aliasResolver::normalize(name);
+    for (int role = ROLE_CANDIDATE; role < ROLE_COUNT; role++){
+        if (aliasResolver::normalize(roleName(role)) == key)
+            return role;
+    }
+    return ROLE_UNKNOWN;
+}
+
+/************************************************************/
+// Function name: load
+// Description: Reads role lines of the form "Name = role". Blank lines and lines starting with # are skipped, as
+//              are lines with an unknown role.
+// Parameters: istream &in - role table text
+// Return Value: int - number of roles read
+/************************************************************/
+int roleModel::load(istream &in){
+    string line;
+    int count = 0;
+
+    while (getline(in, line)){
+        size_t equals = line.find('=');
+        string name = aliasResolver::normalize(string_view(line).substr(0, equals));
+        if (name.empty() || name[0] == '#' || equals == string::npos)
+            continue;
+
+        int role = parseRole(line.substr(equals + 1));
+        if (role == ROLE_UNKNOWN)
+            continue;
+
+        table[name] = role;
+        count++;
+    }
+    return count;
+}
+
+/************************************************************/
+// Function name: loadFile
+// Description: Reads a role table file.
+// Parameters: const string& path - file to read
+// Return Value: int - number of roles read, -1 if the file could not be opened
+/************************************************************/
+int roleModel::loadFile(const string& path){
+    ifstream in(path);
+    if (!in.is_open())
+        return -1;
+    return load(in);
+}
+
+/************************************************************/
+// Function name: clear
+// Description: Forgets the role table.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void roleModel::clear(){
+    table.clear();
+}
+
+/************************************************************/
+// Function name: lookup
+// Description: Finds a role from the table or the shape of the name alone.
+// Parameters: const string& name - canonical speaker name
+// Return Value: int - speakerRole, ROLE_UNKNOWN if the turns must decide
+/************************************************************/
+int roleModel::lookup(const string& name) const{
+    string key = aliasResolver::normalize(name);
+
+    auto found = table.find(key);
+    if (found != table.end())
+        return found->second;
+
+    //"moderator", optionally numbered
+    if (key.compare(0, 9, "moderator") == 0){
+        size_t i = 9;
+        while (i < key.size() && (key[i] == ' ' || isdigit((unsigned char)key[i])))
+            i++;
+        if (i == key.size())
+            return ROLE_MODERATOR;
+    }
+
+    for (const char* other : OTHER_NAMES){
+        if (key == other)
+            return ROLE_OTHER;
+    }
+
+    return ROLE_UNKNOWN;
+}
+
+/************************************************************/
+// Function name: classify
+// Description: Assigns a speaker's role in one event.
+// Parameters: const string& name - canonical speaker name
+//             int turns - turns the speaker took
+//             int questions - question-shaped turns followed by a different speaker
+// Return Value: int - speakerRole, never ROLE_UNKNOWN
+/************************************************************/
+int roleModel::classify(const string& name, int turns, int questions) const{
+    int role = lookup(name);
+    if (role != ROLE_UNKNOWN)
+        return role;
+
+    if (turns > 0 && questions >= MODERATOR_QUESTION_SHARE * turns)
+        return ROLE_MODERATOR;
+    return ROLE_CANDIDATE;
+}
+
+/************************************************************/
+// Function name: isQuestion
+// Description: returns whether a turn is question-shaped: short and containing a question mark
+// Parameters: string_view script - turn text
+//             int words - turn word count
+// Return Value: bool - true if question-shaped
+/************************************************************/
+bool roleModel::isQuestion(string_view script, int words){
+    return words <= QUESTION_MAX_WORDS && script.find('?') != string_view::npos;
+}
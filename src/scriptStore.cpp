@@ -0,0 +1,456 @@
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include "scriptStore.h"
+
+using namespace std;
+
+//codec parameters
+static const size_t MIN_MATCH = 4;
+static const size_t HASH_BITS = 14;
+static const size_t MAX_OFFSET = 65535;
+static const int MAX_CHAIN = 16;
+
+//default constructor
+scriptStore::scriptStore(){
+    cacheCapacity = 4;
+    spillFile = nullptr;
+    spilling = false;
+    dropping = false;
+}
+
+//overloaded constructor
+scriptStore::scriptStore(size_t cacheBlocks){
+    cacheCapacity = cacheBlocks > 0 ? cacheBlocks : 1;
+    spillFile = nullptr;
+    spilling = false;
+    dropping = false;
+}
+
+//destructor
+scriptStore::~scriptStore(){
+    if (spillFile)
+        fclose(spillFile);
+}
+
+/************************************************************/
+// Function name: shared
+// Description: returns the store used by every speech
+// Parameters: none
+// Return Value: scriptStore& - shared store
+/************************************************************/
+scriptStore& scriptStore::shared(){
+    static scriptStore store;
+    return store;
+}
+
+/************************************************************/
+// Function name: add
+// Description: Appends a script to the open block.
+// Parameters: const string& script - text to store
+// Return Value: scriptHandle - location of the stored text
+/************************************************************/
+scriptHandle scriptStore::add(const string& script){
+    scriptHandle handle;
+    if (dropping){
+        stats.droppedBytes += script.size();
+        return handle;
+    }
+
+    handle.block = blocks.size();
+    handle.offset = openBlock.size();
+    handle.length = script.size();
+
+    openBlock.append(script);
+    stats.rawBytes += script.size();
+
+    return handle;
+}
+
+/************************************************************/
+// Function name: seal
+// Description: Compresses the open block and starts a new one. Called at the end of each event.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void scriptStore::seal(){
+    if (openBlock.empty())
+        return;
+
+    block sealed;
+    sealed.rawSize = openBlock.size();
+    sealed.checksum = checksum(openBlock);
+    sealed.compressed = compress(openBlock);
+    sealed.compressedSize = sealed.compressed.size();
+    stats.compressedBytes += sealed.compressed.size();
+
+    //a block that fails to spill stays in memory
+    if (spilling)
+        spillBlock(sealed);
+
+    blocks.push_back(move(sealed));
+    openBlock.clear();
+}
+
+/************************************************************/
+// Function name: clear
+// Description: Releases every block and cached block.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void scriptStore::clear(){
+    blocks.clear();
+    openBlock.clear();
+    cache.clear();
+    stats = scriptStoreStats();
+
+    if (spillFile)
+        fclose(spillFile);
+    spillFile = nullptr;
+    spilling = false;
+    dropping = false;
+}
+
+/************************************************************/
+// Function name: spillBlock
+// Description: Appends a block's compressed bytes to the spill file and releases them.
+// Parameters: block &sealed - block still in memory
+// Return Value: bool - false if the write failed, leaving the block in memory
+/************************************************************/
+bool scriptStore::spillBlock(block &sealed){
+    if (fseek(spillFile, 0, SEEK_END) != 0)
+        return false;
+    long offset = ftell(spillFile);
+    if (offset < 0 || fwrite(sealed.compressed.data(), 1, sealed.compressed.size(), spillFile) != sealed.compressed.size())
+        return false;
+
+    sealed.spillOffset = offset;
+    stats.spilledBytes += sealed.compressed.size();
+    string().swap(sealed.compressed);
+    return true;
+}
+
+/************************************************************/
+// Function name: spill
+// Description: Moves every sealed block to a temporary file, and every block sealed later. The file is removed
+//              when the store is cleared or destroyed.
+// Parameters: none
+// Return Value: bool - false if no temporary file could be created or written
+/************************************************************/
+bool scriptStore::spill(){
+    if (!spillFile)
+        spillFile = tmpfile();
+    if (!spillFile)
+        return false;
+
+    spilling = true;
+    for (auto& sealed : blocks){
+        if (sealed.spillOffset < 0 && !spillBlock(sealed))
+            return false;
+    }
+    return true;
+}
+
+/************************************************************/
+// Function name: setDropping
+// Description: Turns dropping on or off. While dropping, add discards the script and returns an empty handle.
+// Parameters: bool drop - true to drop new scripts
+// Return Value: none
+/************************************************************/
+void scriptStore::setDropping(bool drop){
+    dropping = drop;
+}
+
+/************************************************************/
+// Function name: isSpilling / isDropping
+// Description: return whether sealed blocks go to the spill file, and whether new scripts are dropped
+// Parameters: none
+// Return Value: bool - mode flag
+/************************************************************/
+bool scriptStore::isSpilling() const {return spilling;}
+bool scriptStore::isDropping() const {return dropping;}
+
+/************************************************************/
+// Function name: memoryBytes
+// Description: Estimates the heap bytes held: the open block, blocks kept in memory and the cache.
+// Parameters: none
+// Return Value: size_t - bytes
+/************************************************************/
+size_t scriptStore::memoryBytes() const{
+    size_t bytes = openBlock.capacity() + blocks.capacity() * sizeof(block);
+    for (auto& sealed : blocks)
+        bytes += sealed.compressed.capacity();
+    for (auto& cached : cache)
+        bytes += cached.second.capacity() + sizeof(cached);
+    return bytes;
+}
+
+/************************************************************/
+// Function name: fetch
+// Description: Returns the decompressed text of a sealed block, decompressing it into the cache on a miss.
+// Parameters: int index - block index
+// Return Value: const string& - decompressed block
+/************************************************************/
+const string& scriptStore::fetch(int index){
+    for (auto it = cache.begin(); it != cache.end(); it++){
+        if (it->first == index){
+            stats.cacheHits++;
+            cache.splice(cache.begin(), cache, it); //move to front
+            return cache.front().second;
+        }
+    }
+
+    stats.cacheMisses++;
+    if (cache.size() >= cacheCapacity)
+        cache.pop_back();
+
+    auto start = chrono::steady_clock::now();
+    const block& sealed = blocks[index];
+    if (sealed.spillOffset >= 0){
+        //read the compressed bytes back; a failed read leaves the block blank
+        string compressed(sealed.compressedSize, '\0');
+        if (fseek(spillFile, sealed.spillOffset, SEEK_SET) != 0 || fread(&compressed[0], 1, compressed.size(), spillFile) != compressed.size())
+            compressed.clear();
+        cache.emplace_front(index, decompress(compressed, sealed.rawSize));
+    }
+    else{
+        cache.emplace_front(index, decompress(sealed.compressed, sealed.rawSize));
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    stats.decompressSeconds += elapsed.count();
+    stats.decompressedBytes += blocks[index].rawSize;
+
+    return cache.front().second;
+}
+
+/************************************************************/
+// Function name: view
+// Description: Returns the text of a script without copying it.
+//              The view is valid until its block is evicted from the cache or, for the open block, until the next add.
+// Parameters: scriptHandle handle - script to view
+// Return Value: string_view - script text, empty if the handle is bad or its block could not be read
+/************************************************************/
+string_view scriptStore::view(scriptHandle handle){
+    if (handle.block < 0 || (size_t)handle.block > blocks.size())
+        return string_view();
+
+    string_view text = (size_t)handle.block == blocks.size() ? string_view(openBlock) : string_view(fetch(handle.block));
+
+    //a block that could not be read back from the spill file is blank
+    if ((size_t)handle.offset + handle.length > text.size())
+        return string_view();
+    return text.substr(handle.offset, handle.length);
+}
+
+/************************************************************/
+// Function name: readBlock
+// Description: Returns a copy of a block's text without touching the cache, so several threads can read blocks at
+//              once while nothing is being added.
+// Parameters: int index - block index; the open block's index returns the open block
+// Return Value: string - block text, empty for a bad index
+/************************************************************/
+string scriptStore::readBlock(int index) const{
+    if (index < 0 || (size_t)index > blocks.size())
+        return string();
+    if ((size_t)index == blocks.size())
+        return openBlock;
+
+    const block& sealed = blocks[index];
+    if (sealed.spillOffset < 0)
+        return decompress(sealed.compressed, sealed.rawSize);
+
+    //pread leaves the shared file position alone
+    string compressed(sealed.compressedSize, '\0');
+    if (pread(fileno(spillFile), &compressed[0], compressed.size(), sealed.spillOffset) != (ssize_t)compressed.size())
+        compressed.clear();
+    return decompress(compressed, sealed.rawSize);
+}
+
+/************************************************************/
+// Function name: getStats
+// Description: returns the instrumentation counters
+// Parameters: none
+// Return Value: const scriptStoreStats& - counters
+/************************************************************/
+const scriptStoreStats& scriptStore::getStats() const {return stats;}
+
+/************************************************************/
+// Function name: getBlockCount
+// Description: returns number of sealed blocks
+// Parameters: none
+// Return Value: int - block count
+/************************************************************/
+int scriptStore::getBlockCount() const {return blocks.size();}
+
+/************************************************************/
+// Function name: getChecksum
+// Description: returns the checksum of a block's text, taken when it was sealed, so callers can tell whether text
+//              changed without decompressing it
+// Parameters: int index - block index; the open block's index checksums the open block
+// Return Value: uint64_t - checksum, 0 for a bad index
+/************************************************************/
+uint64_t scriptStore::getChecksum(int index) const{
+    if (index < 0 || (size_t)index > blocks.size())
+        return 0;
+    if ((size_t)index == blocks.size())
+        return checksum(openBlock);
+    return blocks[index].checksum;
+}
+
+/************************************************************/
+// Function name: checksum
+// Description: FNV-1a hash of a run of text
+// Parameters: string_view text - text to hash
+// Return Value: uint64_t - hash
+/************************************************************/
+uint64_t scriptStore::checksum(string_view text){
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text){
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+//write an unsigned LEB128 value
+static void putVarint(string& out, size_t value){
+    while (value >= 0x80){
+        out.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+//read an unsigned LEB128 value, returns false on truncated input
+static bool getVarint(const string& in, size_t& pos, size_t& value){
+    value = 0;
+    int shift = 0;
+    while (pos < in.size() && shift < 64){
+        unsigned char byte = in[pos++];
+        value |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+        shift += 7;
+    }
+    return false;
+}
+
+static inline unsigned int hash4(const char* p){
+    unsigned int v;
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/************************************************************/
+// Function name: compress
+// Description: LZ77 compression. The output is a series of sequences, each a literal run followed by a back reference:
+//              varint literal count, literal bytes, varint (match length - MIN_MATCH), varint offset.
+//              The last sequence has no back reference.
+// Parameters: const string& raw - text to compress
+// Return Value: string - compressed bytes
+/************************************************************/
+string scriptStore::compress(const string& raw){
+    string out;
+    out.reserve(raw.size() / 2);
+
+    vector<int> head(1 << HASH_BITS, -1);
+    vector<int> chain(raw.size(), -1); //previous position with the same hash
+    const char* src = raw.data();
+    size_t n = raw.size();
+    size_t pos = 0, literalStart = 0;
+
+    while (pos + MIN_MATCH <= n){
+        unsigned int h = hash4(src + pos);
+
+        //walk the hash chain for the longest match
+        size_t bestLength = 0, bestOffset = 0;
+        int candidate = head[h];
+        for (int depth = 0; candidate >= 0 && depth < MAX_CHAIN && pos - candidate <= MAX_OFFSET; depth++){
+            size_t matchLength = 0;
+            while (pos + matchLength < n && src[candidate + matchLength] == src[pos + matchLength])
+                matchLength++;
+            if (matchLength > bestLength){
+                bestLength = matchLength;
+                bestOffset = pos - candidate;
+            }
+            candidate = chain[candidate];
+        }
+
+        chain[pos] = head[h];
+        head[h] = pos;
+
+        if (bestLength >= MIN_MATCH){
+            putVarint(out, pos - literalStart);
+            out.append(src + literalStart, pos - literalStart);
+            putVarint(out, bestLength - MIN_MATCH);
+            putVarint(out, bestOffset);
+
+            //index the skipped positions so later matches can reach them
+            size_t end = pos + bestLength;
+            for (pos++; pos < end && pos + MIN_MATCH <= n; pos++){
+                h = hash4(src + pos);
+                chain[pos] = head[h];
+                head[h] = pos;
+            }
+            pos = end;
+            literalStart = pos;
+        }
+        else{
+            pos++;
+        }
+    }
+
+    //final literal run
+    putVarint(out, n - literalStart);
+    out.append(src + literalStart, n - literalStart);
+
+    return out;
+}
+
+/************************************************************/
+// Function name: decompress
+// Description: Reverses compress.
+// Parameters: const string& packed - compressed bytes
+//             size_t rawSize - size of the original text
+// Return Value: string - original text, or an empty string if the input is corrupt
+/************************************************************/
+string scriptStore::decompress(const string& packed, size_t rawSize){
+    string out;
+    out.resize(rawSize);
+
+    size_t in = 0, outPos = 0;
+    size_t literals, matchLength, offset;
+
+    while (in < packed.size()){
+        if (!getVarint(packed, in, literals) || literals > packed.size() - in || literals > rawSize - outPos)
+            return string();
+        memcpy(&out[outPos], packed.data() + in, literals);
+        in += literals;
+        outPos += literals;
+
+        if (in == packed.size())
+            break;
+
+        if (!getVarint(packed, in, matchLength) || !getVarint(packed, in, offset))
+            return string();
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > outPos || matchLength > rawSize - outPos)
+            return string();
+
+        //byte copy; the match may overlap its own output
+        for (size_t i = 0; i < matchLength; i++, outPos++)
+            out[outPos] = out[outPos - offset];
+    }
+
+    if (outPos != rawSize)
+        return string();
+
+    return out;
+}
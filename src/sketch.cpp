@@ -0,0 +1,274 @@
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "sketch.h"
+
+using namespace std;
+
+//default constructor
+quantileSketch::quantileSketch(){
+    k = 200;
+    count = 0;
+    minValue = 0.0;
+    maxValue = 0.0;
+    oddOffset = false;
+    totalCapacity = 0;
+    retained = 0;
+    sortedValid = false;
+    setLevelCount(1);
+}
+
+//overloaded constructor
+quantileSketch::quantileSketch(int kValue){
+    k = kValue > 8 ? kValue : 8;
+    count = 0;
+    minValue = 0.0;
+    maxValue = 0.0;
+    oddOffset = false;
+    totalCapacity = 0;
+    retained = 0;
+    sortedValid = false;
+    setLevelCount(1);
+}
+
+/************************************************************/
+// Function name: capacity
+// Description: Returns how many items a level may hold. Lower levels shrink geometrically below the top level's k.
+// Parameters: size_t level - level index
+// Return Value: size_t - level capacity
+/************************************************************/
+size_t quantileSketch::capacity(size_t level) const{
+    return depthCapacities[levels.size() - 1 - level];
+}
+
+/************************************************************/
+// Function name: setLevelCount
+// Description: Adds levels, extending the capacity table to the new depth and updating the total capacity.
+// Parameters: size_t levelCount - number of levels, no fewer than now
+// Return Value: none
+/************************************************************/
+void quantileSketch::setLevelCount(size_t levelCount){
+    levels.resize(levelCount);
+    while (depthCapacities.size() < levelCount){
+        size_t cap = (size_t)ceil(k * pow(2.0 / 3.0, (double)depthCapacities.size()));
+        depthCapacities.push_back(cap > 2 ? cap : 2);
+    }
+
+    totalCapacity = 0;
+    for (size_t depth = 0; depth < levelCount; depth++)
+        totalCapacity += depthCapacities[depth];
+}
+
+/************************************************************/
+// Function name: compress
+// Description: While the sketch holds more items than its total capacity, compacts the lowest full level.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void quantileSketch::compress(){
+    while (retained >= totalCapacity){
+        //compact the lowest level that is over its capacity
+        size_t level = 0;
+        while (levels[level].size() < capacity(level))
+            level++;
+
+        if (level + 1 == levels.size())
+            setLevelCount(levels.size() + 1);
+
+        vector<float>& items = levels[level];
+        sort(items.begin(), items.end());
+
+        //an odd item out stays behind
+        size_t keep = items.size() % 2;
+        size_t start = keep + (oddOffset ? 1 : 0);
+        for (size_t i = start; i < items.size(); i += 2)
+            levels[level + 1].push_back(items[i]);
+        oddOffset = !oddOffset;
+
+        retained -= items.size() - keep;
+        retained += (items.size() - start + 1) / 2;
+        if (keep)
+            items.resize(1);
+        else
+            items.clear();
+    }
+}
+
+/************************************************************/
+// Function name: add
+// Description: Adds one value to the sketch.
+// Parameters: float value - value to add
+// Return Value: none
+/************************************************************/
+void quantileSketch::add(float value){
+    if (count == 0 || value < minValue)
+        minValue = value;
+    if (count == 0 || value > maxValue)
+        maxValue = value;
+    count++;
+
+    levels[0].push_back(value);
+    retained++;
+    sortedValid = false;
+    compress();
+}
+
+/************************************************************/
+// Function name: merge
+// Description: Folds another sketch into this one.
+// Parameters: const quantileSketch& other - sketch to merge
+// Return Value: none
+/************************************************************/
+void quantileSketch::merge(const quantileSketch& other){
+    if (other.count == 0)
+        return;
+
+    if (count == 0 || other.minValue < minValue)
+        minValue = other.minValue;
+    if (count == 0 || other.maxValue > maxValue)
+        maxValue = other.maxValue;
+    count += other.count;
+
+    if (other.levels.size() > levels.size())
+        setLevelCount(other.levels.size());
+    for (size_t level = 0; level < other.levels.size(); level++)
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+    retained += other.retained;
+    sortedValid = false;
+
+    compress();
+}
+
+/************************************************************/
+// Function name: quantile
+// Description: Estimates the value at a rank. Exact while fewer than k values have been added. The first call after
+//              an add or merge sorts the items; later calls only search them, so a sketch must not be read from
+//              several threads at once.
+// Parameters: double q - rank between 0 and 1
+// Return Value: float - estimated value, 0 if empty
+/************************************************************/
+float quantileSketch::quantile(double q) const{
+    if (count == 0)
+        return 0.0;
+    if (q <= 0.0)
+        return minValue;
+    if (q >= 1.0)
+        return maxValue;
+
+    if (!sortedValid){
+        vector<pair<float, long> > weighted;
+        weighted.reserve(retained);
+        for (size_t level = 0; level < levels.size(); level++){
+            for (float value : levels[level])
+                weighted.push_back({value, 1L << level});
+        }
+        sort(weighted.begin(), weighted.end());
+
+        sortedValues.resize(weighted.size());
+        cumulativeWeights.resize(weighted.size());
+        long cumulative = 0;
+        for (size_t i = 0; i < weighted.size(); i++){
+            cumulative += weighted[i].second;
+            sortedValues[i] = weighted[i].first;
+            cumulativeWeights[i] = cumulative;
+        }
+        sortedValid = true;
+    }
+    if (sortedValues.empty())
+        return maxValue;
+
+    //nearest rank: smallest value covering q of the total weight
+    double target = q * cumulativeWeights.back();
+    auto covering = lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), target, [](long weight, double t){
+        return weight < t;
+    });
+    if (covering == cumulativeWeights.end())
+        return maxValue;
+    return sortedValues[covering - cumulativeWeights.begin()];
+}
+
+/************************************************************/
+// Function name: getCount
+// Description: returns number of values added
+// Parameters: none
+// Return Value: long - value count
+/************************************************************/
+long quantileSketch::getCount() const {return count;}
+
+/************************************************************/
+// Function name: getMin
+// Description: returns exact minimum
+// Parameters: none
+// Return Value: float - minimum, 0 if empty
+/************************************************************/
+float quantileSketch::getMin() const {return minValue;}
+
+/************************************************************/
+// Function name: getMax
+// Description: returns exact maximum
+// Parameters: none
+// Return Value: float - maximum, 0 if empty
+/************************************************************/
+float quantileSketch::getMax() const {return maxValue;}
+
+/************************************************************/
+// Function name: getRetained
+// Description: returns number of items stored in the sketch
+// Parameters: none
+// Return Value: size_t - retained items
+/************************************************************/
+size_t quantileSketch::getRetained() const {return retained;}
+
+
+//constructor
+logHistogram::logHistogram(){
+    for (int i = 0; i < BUCKETS; i++)
+        counts[i] = 0;
+}
+
+/************************************************************/
+// Function name: add
+// Description: Counts a value. Bucket 0 holds values below 1, bucket i holds [2^(i-1), 2^i), the last bucket holds the rest.
+// Parameters: float value - value to count
+// Return Value: none
+/************************************************************/
+void logHistogram::add(float value){
+    int bucket = 0;
+    if (value >= 1.0)
+        bucket = min(BUCKETS - 1, (int)floor(log2(value)) + 1);
+    counts[bucket]++;
+}
+
+/************************************************************/
+// Function name: merge
+// Description: Adds another histogram's counts to this one.
+// Parameters: const logHistogram& other - histogram to merge
+// Return Value: none
+/************************************************************/
+void logHistogram::merge(const logHistogram& other){
+    for (int i = 0; i < BUCKETS; i++)
+        counts[i] += other.counts[i];
+}
+
+/************************************************************/
+// Function name: getBucket
+// Description: returns a bucket's count
+// Parameters: int bucket - bucket index
+// Return Value: long - count
+/************************************************************/
+long logHistogram::getBucket(int bucket) const{
+    if (bucket < 0 || bucket >= BUCKETS)
+        return 0;
+    return counts[bucket];
+}
+
+/************************************************************/
+// Function name: bucketLow
+// Description: returns the smallest value a bucket holds
+// Parameters: int bucket - bucket index
+// Return Value: float - lower bound
+/************************************************************/
+float logHistogram::bucketLow(int bucket){
+    return bucket <= 0 ? 0.0 : (float)(1 << (bucket - 1));
+}
@@ -11,8 +11,8 @@ using namespace std;
 //default constructor
 speech::speech(){
     position = 0;
-    speaker = "";
-    script = "";
+    speakerId = -1;
+    script = scriptHandle();
     length = 0.0;
     wordCount = 0;
 
@@ -21,10 +21,19 @@ speech::speech(){
 //overloaded constructor
 speech::speech(int pos, string speakerString, string scriptString, float lengthFloat){
     position = pos;
-    speaker = speakerString;
-    script = scriptString;
+    speakerId = aliasResolver::shared().resolve(speakerString);
     length = lengthFloat;
-    wordCount = countWord(script);
+    wordCount = countWord(scriptString);
+    script = scriptStore::shared().add(scriptString);
+}
+
+//overloaded constructor, for a speaker already resolved
+speech::speech(int pos, int speaker, string scriptString, float lengthFloat){
+    position = pos;
+    speakerId = speaker;
+    length = lengthFloat;
+    wordCount = countWord(scriptString);
+    script = scriptStore::shared().add(scriptString);
 }
 
 /************************************************************/
@@ -55,31 +64,55 @@ int speech::countWord(string transcript){
 // Parameters: none
 // Return Value: int - position
 /************************************************************/
-int speech::getPosition(){return position;}
+int speech::getPosition() const {return position;}
 
 /************************************************************/
 // Function name: getSpeaker
-// Description: returns speaker name
+// Description: returns canonical speaker name
 // Parameters: none
 // Return Value: string - speaker name
 /************************************************************/
-const string speech::getSpeaker() const{return speaker;}
+const string speech::getSpeaker() const{return aliasResolver::shared().getName(speakerId);}
+
+/************************************************************/
+// Function name: getSpeakerId
+// Description: returns interned speaker id
+// Parameters: none
+// Return Value: int - id from aliasResolver::shared()
+/************************************************************/
+int speech::getSpeakerId() const {return speakerId;}
 
 /************************************************************/
 // Function name: getScript
-// Description: returns script text
+// Description: returns a copy of the script text
 // Parameters: none
-// Return Value: string -speaker name
+// Return Value: string - script text
 /************************************************************/
-const string speech::getScript() const {return script;}
+const string speech::getScript() const {return string(getScriptView());}
+
+/************************************************************/
+// Function name: getScriptView
+// Description: returns the script text without copying it. Valid until the store evicts the script's block.
+// Parameters: none
+// Return Value: string_view - script text
+/************************************************************/
+string_view speech::getScriptView() const {return scriptStore::shared().view(script);}
+
+/************************************************************/
+// Function name: getScriptHandle
+// Description: returns where the script is stored
+// Parameters: none
+// Return Value: scriptHandle - location in scriptStore::shared(), or an empty handle if the script was dropped
+/************************************************************/
+scriptHandle speech::getScriptHandle() const {return script;}
 
 /************************************************************/
 // Function name: getLength
 // Description: returns speaking time
 // Parameters: none
-// Return Value: int - speech time length
+// Return Value: float - speech time length in seconds
 /************************************************************/
-const int speech::getLength() const {return length;}
+const float speech::getLength() const {return length;}
 
 /************************************************************/
 // Function name: getCount
@@ -88,3 +121,34 @@ const int speech::getLength() const {return length;}
 // Return Value: int - word count
 /************************************************************/
 const int speech::getCount() const {return wordCount;}
+
+/************************************************************/
+// Function name: getPace
+// Description: returns speaking rate
+// Parameters: none
+// Return Value: float - words per minute, 0 if the speech has no length
+/************************************************************/
+float speech::getPace() const{
+    if (length <= 0)
+        return 0.0;
+    return wordCount * 60.0 / length;
+}
+
+/************************************************************/
+// Function name: isPaceOutlier
+// Description: returns whether the speech's length is missing or its rate is implausible
+// Parameters: none
+// Return Value: bool - true if flagged
+/************************************************************/
+bool speech::isPaceOutlier() const {return paceOutlier(wordCount, length);}
+
+/************************************************************/
+// Function name: paceOutlier
+// Description: Flags turns with no length or a rate outside MIN_PACE to MAX_PACE words per minute.
+// Parameters: int words - word count
+//             float seconds - turn length
+// Return Value: bool - true if flagged
+/************************************************************/
+bool speech::paceOutlier(int words, float seconds){
+    return !(seconds > 0) || words * 60.0f < MIN_PACE * seconds || words * 60.0f > MAX_PACE * seconds;
+}
@@ -0,0 +1,230 @@
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include "timeline.h"
+
+using namespace std;
+
+/************************************************************/
+// Function name: size
+// Description: returns number of events in the series
+// Parameters: none
+// Return Value: size_t - row count
+/************************************************************/
+size_t speakerSeries::size() const {return slot.size();}
+
+
+//constructor
+timeline::timeline(){
+    sorted = true;
+}
+
+/************************************************************/
+// Function name: addEvent
+// Description: Appends a finished event: one row for each of its speakers.
+// Parameters: const event& eventObj - event to add
+// Return Value: none
+/************************************************************/
+void timeline::addEvent(const event& eventObj){
+    int slot = dates.size();
+    dates.push_back(eventObj.getDate());
+    names.push_back(eventObj.getName());
+    speakerCounts.push_back(eventObj.getSpeakerCount());
+    if (slot > 0 && dates[slot] < dates[slot - 1])
+        sorted = false;
+
+    const map<string, speakerStats>& speakers = eventObj.getSpeakers();
+    float total = eventObj.getTotalTime();
+
+    //rank by speaking time, name breaking ties
+    vector<const pair<const string, speakerStats>*> byTime;
+    for (auto& speaker : speakers)
+        byTime.push_back(&speaker);
+    stable_sort(byTime.begin(), byTime.end(), [](const pair<const string, speakerStats>* a, const pair<const string, speakerStats>* b){
+        return a->second.totalSpeakingTime > b->second.totalSpeakingTime;
+    });
+
+    for (size_t r = 0; r < byTime.size(); r++){
+        const speakerStats& stats = byTime[r]->second;
+        if (stats.speakerId < 0)
+            continue;
+        if (stats.speakerId >= (int)series.size())
+            series.resize(stats.speakerId + 1);
+
+        speakerSeries& rows = series[stats.speakerId];
+        rows.slot.push_back(slot);
+        rows.words.push_back(stats.totalWordCount);
+        rows.time.push_back(stats.totalSpeakingTime);
+        rows.turns.push_back(stats.timesSpoke);
+        rows.share.push_back(total > 0 ? 100.0 * stats.totalSpeakingTime / total : 0.0);
+        rows.rank.push_back(r + 1);
+    }
+}
+
+//reorders one column by a row permutation
+template <typename T>
+static void permute(vector<T>& column, const vector<int>& order){
+    vector<T> copy(column.size());
+    for (size_t i = 0; i < order.size(); i++)
+        copy[i] = column[order[i]];
+    column.swap(copy);
+}
+
+/************************************************************/
+// Function name: finish
+// Description: Puts the events in date order, keeping arrival order for equal dates, and reorders every series to match.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void timeline::finish(){
+    if (sorted)
+        return;
+
+    vector<int> order(dates.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b){ return dates[a] < dates[b]; });
+
+    vector<int> newSlot(order.size());
+    for (size_t i = 0; i < order.size(); i++)
+        newSlot[order[i]] = i;
+
+    permute(dates, order);
+    permute(names, order);
+    permute(speakerCounts, order);
+
+    for (auto& rows : series){
+        for (int& slot : rows.slot)
+            slot = newSlot[slot];
+
+        vector<int> rowOrder(rows.size());
+        iota(rowOrder.begin(), rowOrder.end(), 0);
+        sort(rowOrder.begin(), rowOrder.end(), [&](int a, int b){ return rows.slot[a] < rows.slot[b]; });
+
+        permute(rows.slot, rowOrder);
+        permute(rows.words, rowOrder);
+        permute(rows.time, rowOrder);
+        permute(rows.turns, rowOrder);
+        permute(rows.share, rowOrder);
+        permute(rows.rank, rowOrder);
+    }
+
+    sorted = true;
+}
+
+/************************************************************/
+// Function name: clear
+// Description: Removes every event and series.
+// Parameters: none
+// Return Value: none
+/************************************************************/
+void timeline::clear(){
+    dates.clear();
+    names.clear();
+    speakerCounts.clear();
+    series.clear();
+    sorted = true;
+}
+
+/************************************************************/
+// Function name: getEventCount
+// Description: returns number of events added
+// Parameters: none
+// Return Value: int - event count
+/************************************************************/
+int timeline::getEventCount() const {return dates.size();}
+
+/************************************************************/
+// Function name: getDate
+// Description: returns the date of an event
+// Parameters: int slot - event index
+// Return Value: const string& - date
+/************************************************************/
+const string& timeline::getDate(int slot) const {return dates.at(slot);}
+
+/************************************************************/
+// Function name: getName
+// Description: returns the name of an event
+// Parameters: int slot - event index
+// Return Value: const string& - event name
+/************************************************************/
+const string& timeline::getName(int slot) const {return names.at(slot);}
+
+/************************************************************/
+// Function name: getSpeakerCount
+// Description: returns number of speakers in an event
+// Parameters: int slot - event index
+// Return Value: int - speaker count
+/************************************************************/
+int timeline::getSpeakerCount(int slot) const {return speakerCounts.at(slot);}
+
+/************************************************************/
+// Function name: getSeries
+// Description: returns a speaker's rows
+// Parameters: int id - speaker id
+// Return Value: const speakerSeries* - rows, or nullptr if the speaker never spoke
+/************************************************************/
+const speakerSeries* timeline::getSeries(int id) const{
+    if (id < 0 || id >= (int)series.size() || series[id].size() == 0)
+        return nullptr;
+    return &series[id];
+}
+
+/************************************************************/
+// Function name: trend
+// Description: Least-squares slope of a speaker's share of speaking time against the season's event index, so
+//              events a speaker missed still count as elapsed time.
+// Parameters: int id - speaker id
+// Return Value: float - change in share, in percentage points per event; 0 with fewer than two events
+/************************************************************/
+float timeline::trend(int id) const{
+    const speakerSeries* rows = getSeries(id);
+    if (!rows || rows->size() < 2)
+        return 0.0;
+
+    double n = rows->size(), meanX = 0, meanY = 0;
+    for (size_t i = 0; i < rows->size(); i++){
+        meanX += rows->slot[i];
+        meanY += rows->share[i];
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double covariance = 0, variance = 0;
+    for (size_t i = 0; i < rows->size(); i++){
+        covariance += (rows->slot[i] - meanX) * (rows->share[i] - meanY);
+        variance += (rows->slot[i] - meanX) * (rows->slot[i] - meanX);
+    }
+    return variance > 0 ? covariance / variance : 0.0;
+}
+
+/************************************************************/
+// Function name: delta
+// Description: returns the change in a speaker's share from their previous event
+// Parameters: int id - speaker id
+//             size_t row - row in the speaker's series
+// Return Value: float - change in percentage points; 0 for the first row or a bad row
+/************************************************************/
+float timeline::delta(int id, size_t row) const{
+    const speakerSeries* rows = getSeries(id);
+    if (!rows || row == 0 || row >= rows->size())
+        return 0.0;
+    return rows->share[row] - rows->share[row - 1];
+}
+
+/************************************************************/
+// Function name: rankHistory
+// Description: returns a speaker's rank in every event of the season
+// Parameters: int id - speaker id
+// Return Value: vector<int> - rank per event in date order, 0 where the speaker did not speak
+/************************************************************/
+vector<int> timeline::rankHistory(int id) const{
+    vector<int> ranks(dates.size(), 0);
+    const speakerSeries* rows = getSeries(id);
+    if (rows){
+        for (size_t i = 0; i < rows->size(); i++)
+            ranks[rows->slot[i]] = rows->rank[i];
+    }
+    return ranks;
+}
@@ -0,0 +1,103 @@
+/*!	\file fuzz_csv.cpp
+*	\brief Fuzz target for the CSV reader and word counter
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: fuzz_csv.cpp\n
+*   \n
+*   Feeds arbitrary bytes to csvParser, parseTranscriptRow and speech::countWord. \n
+*   Checks that splitting the input into chunks never changes the parsed records. \n
+*   Built with -DUSE_LIBFUZZER and -fsanitize=fuzzer this is a libFuzzer target ("make fuzz-libfuzzer").
+*   Otherwise it is a standalone program that runs random inputs, or the files named on the command line ("make fuzz").
+*
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstdint>
+#include "csvParser.h"
+#include "speech.h"
+
+using namespace std;
+
+//parse data in pieces of the given size, returning every record joined into one string
+static string parseAll(const uint8_t* data, size_t size, size_t chunk, csvStats& stats){
+    string out;
+    transcriptRow row;
+
+    csvParser parser([&](const vector<string>& fields, size_t count, long line){
+        out += to_string(line) + ":";
+        for (size_t i = 0; i < count; i++){
+            out += fields[i];
+            out.push_back('\x1f');
+        }
+        out.push_back('\x1e');
+        parseTranscriptRow(fields, count, row, stats);
+    }, &stats);
+
+    for (size_t i = 0; i < size; i += chunk)
+        parser.feed((const char*)data + i, min(chunk, size - i));
+    parser.finish();
+
+    return out;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size){
+    csvStats whole, pieces;
+    string a = parseAll(data, size, size > 0 ? size : 1, whole);
+    string b = parseAll(data, size, 1 + (size > 0 ? data[0] % 13 : 0), pieces);
+
+    if (a != b || whole.records != pieces.records || whole.accepted != pieces.accepted){
+        cerr << "Chunked parse differs from whole parse." << endl;
+        abort();
+    }
+    for (int i = 0; i < CSV_REASON_COUNT; i++){
+        if (whole.reasons[i] != pieces.reasons[i]){
+            cerr << "Chunked parse counted " << csvStats::reasonName(i) << " differently." << endl;
+            abort();
+        }
+    }
+
+    speech sp;
+    int words = sp.countWord(string((const char*)data, size));
+    if (words < 0 || (size_t)words > size){
+        cerr << "Word count out of range." << endl;
+        abort();
+    }
+
+    return 0;
+}
+
+#ifndef USE_LIBFUZZER
+int main(int argc, char** argv){
+    //replay files given on the command line
+    if (argc > 1){
+        for (int i = 1; i < argc; i++){
+            ifstream in(argv[i], ios::binary);
+            ostringstream text;
+            text << in.rdbuf();
+            string input = text.str();
+            LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+        }
+        cout << "Replayed " << argc - 1 << " inputs." << endl;
+        return 0;
+    }
+
+    //random inputs biased towards CSV syntax
+    mt19937 rng(12345);
+    const char alphabet[] = "ab ,.\"\"\r\n\n0123-.9";
+    int runs = 20000;
+    for (int r = 0; r < runs; r++){
+        string input(rng() % 256, ' ');
+        for (char &c : input)
+            c = (rng() % 8 == 0) ? (char)(rng() % 256) : alphabet[rng() % (sizeof(alphabet) - 1)];
+        LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+    }
+    cout << "Ran " << runs << " random inputs." << endl;
+    return 0;
+}
+#endif
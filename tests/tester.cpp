@@ -0,0 +1,1187 @@
+/*!	\file tester.cpp
+*	\brief Test driver
+*
+*   \b Author: Joseph Workoff\n
+*   \b Filename: tester.cpp\n
+*   \n
+*   Unit tests for the CSV parser, speech, event and script store, plus a differential test that runs every
+*   ingest path against the original line-based reader over the bundled CSV and generated corpora. \n
+*   Build with "make tests" and run bin/test from the repository root.
+*
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <vector>
+#include <functional>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include "ingest.h"
+#include "pager.h"
+#include "exporter.h"
+#include "aliases.h"
+#include "concordance.h"
+#include "timeline.h"
+#include "compare.h"
+#include "roles.h"
+#include "lexicon.h"
+
+using namespace std;
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(cond) do{ \
+        checks++; \
+        if (!(cond)){ \
+            failures++; \
+            cout << "FAILED: " << __FILE__ << ":" << __LINE__ << ": " << #cond << endl; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do{ \
+        checks++; \
+        if (!((a) == (b))){ \
+            failures++; \
+            cout << "FAILED: " << __FILE__ << ":" << __LINE__ << ": " << #a << " == " << #b \
+                 << " (" << (a) << " vs " << (b) << ")" << endl; \
+        } \
+    } while (0)
+
+
+/************************************************************/
+// Reference implementation: the original line-based reader.
+// It does not understand "" escapes or newlines inside quotes, so it is only compared on inputs without them.
+/************************************************************/
+namespace reference{
+
+    float getLength(string line, size_t &startPos){
+        float length;
+        startPos++;
+        try{
+            length = stof(line.substr(startPos, string::npos));
+        }
+        catch(const std::exception& e){
+            return 0;
+        }
+        return length;
+    }
+
+    string nextCSV(string line, size_t &startPos){
+        size_t newPos = 0;
+        if (line[startPos] == '"'){
+            startPos++;
+            newPos = line.find('"', startPos);
+        }
+        else
+            newPos = line.find(',', startPos);
+
+        if (newPos >= string::npos)
+            return "Failure";
+
+        string val = line.substr(startPos, newPos - startPos);
+        startPos = newPos;
+        if (line[startPos] == '"')
+            startPos++;
+        return val;
+    }
+
+    void readStream(istream &in, vector<event*> &allSpeeches){
+        string line, date, prevDate, eventName, section, speaker, script;
+        int lineNumber = 1;
+        event* eventObj = nullptr;
+
+        getline(in, line);
+        while (getline(in, line)){
+            size_t pos = 0;
+            if ((date = nextCSV(line, pos)) == "Failure") continue;
+            pos++;
+            if ((eventName = nextCSV(line, pos)) == "Failure") continue;
+            pos++;
+            if ((section = nextCSV(line, pos)) == "Failure") continue;
+            pos++;
+            if ((speaker = nextCSV(line, pos)) == "Failure") continue;
+            pos++;
+            if ((script = nextCSV(line, pos)) == "Failure") continue;
+            float length = getLength(line, pos);
+
+            if (date != prevDate){
+                lineNumber = 1;
+                prevDate = date;
+                eventObj = new event(eventName, date);
+                allSpeeches.emplace_back(eventObj);
+            }
+            else{
+                lineNumber++;
+            }
+            eventObj->addSpeech(speech(lineNumber, speaker, script, length));
+        }
+    }
+}
+
+
+//delete events created by an ingest run
+static void freeEvents(vector<event*> &events){
+    for (event* e : events)
+        delete e;
+    events.clear();
+}
+
+//compare two ingest results field by field
+static bool sameEvents(vector<event*> &a, vector<event*> &b, const string& label){
+    bool same = (a.size() == b.size());
+    for (size_t i = 0; same && i < a.size(); i++){
+        same = a[i]->getName() == b[i]->getName() && a[i]->getDate() == b[i]->getDate()
+            && a[i]->getSpeechCount() == b[i]->getSpeechCount() && a[i]->getWordCount() == b[i]->getWordCount()
+            && a[i]->getTotalTime() == b[i]->getTotalTime() && a[i]->getSpeakerCount() == b[i]->getSpeakerCount();
+
+        map<string, speakerStats> sa = a[i]->getSpeakers(), sb = b[i]->getSpeakers();
+        same = same && sa.size() == sb.size();
+        for (auto ita = sa.begin(), itb = sb.begin(); same && ita != sa.end(); ita++, itb++){
+            same = ita->first == itb->first && ita->second.timesSpoke == itb->second.timesSpoke
+                && ita->second.totalWordCount == itb->second.totalWordCount
+                && ita->second.totalSpeakingTime == itb->second.totalSpeakingTime;
+        }
+
+        auto pa = a[i]->getSpeeches().begin(), pb = b[i]->getSpeeches().begin();
+        for (; same && pa != a[i]->getSpeeches().end() && pb != b[i]->getSpeeches().end(); pa++, pb++){
+            same = pa->getSpeaker() == pb->getSpeaker() && pa->getScript() == pb->getScript()
+                && pa->getLength() == pb->getLength() && pa->getCount() == pb->getCount();
+        }
+    }
+    if (!same)
+        cout << "Mismatch in " << label << endl;
+    return same;
+}
+
+//generate a transcript CSV; rfc adds escaped quotes, embedded newlines and CRLF endings
+static string makeCorpus(unsigned seed, int rows, bool rfc){
+    mt19937 rng(seed);
+    const char* words[] = {"the", "health", "care", "plan", "America", "we", "will", "tax", "climate", "jobs", "I", "believe", "Senator"};
+    const char* speakers[] = {"Joe Biden", "Bernie Sanders", "Elizabeth Warren", "Moderator 1", "Pete Buttigieg", "Amy Klobuchar"};
+    const char* events[] = {"Iowa Debate", "Nevada Debate", "Atlanta, Georgia Debate"};
+    string eol = rfc ? "\r\n" : "\n";
+
+    ostringstream out;
+    out << "date,debate_name,debate_section,speaker,speech,speaking_time_seconds" << eol;
+
+    int eventIndex = 0;
+    for (int r = 0; r < rows; r++){
+        if (r > 0 && rng() % 40 == 0)
+            eventIndex++;
+
+        string script;
+        int count = 1 + rng() % 30;
+        for (int w = 0; w < count; w++){
+            script += words[rng() % 13];
+            int p = rng() % 10;
+            if (p == 0) script += ",";
+            else if (p == 1) script += ".";
+            else if (rfc && p == 2) script += " \"\"quoted\"\"";
+            else if (rfc && p == 3) script += "\n";
+            script += " ";
+        }
+        script += "end.";
+
+        out << "2019-" << (eventIndex % 9 + 10) << "-" << (eventIndex % 20 + 10) << ",";
+        out << "\"" << events[eventIndex % 3] << "\",Part " << (rng() % 3) + 1 << ",";
+        out << speakers[rng() % 6] << ",";
+        out << "\"" << script << "\",";
+        if (rng() % 8 != 0)
+            out << (rng() % 600) / 4.0;
+        out << eol;
+    }
+    return out.str();
+}
+
+//ingest paths that must agree with each other, and with the reference on plain input
+static vector<pair<string, function<void(const string&, vector<event*>&)> > > ingestPaths(){
+    vector<pair<string, function<void(const string&, vector<event*>&)> > > paths;
+    for (size_t chunk : {(size_t)1 << 16, (size_t)4096, (size_t)7, (size_t)1}){
+        paths.push_back({"stream " + to_string(chunk), [chunk](const string& csv, vector<event*>& events){
+            istringstream in(csv);
+            csvStats stats;
+            ingestTranscripts(in, events, stats, chunk);
+        }});
+    }
+    return paths;
+}
+
+
+static void testCsvParser(){
+    string input = "a,\"b \"\"q\"\" c\",d\r\nx,\"multi\nline\",z\r\n\r\nlast,a\"b,\"open";
+    vector<vector<string> > records;
+    vector<long> lines;
+    csvStats stats;
+
+    csvParser parser([&](const vector<string>& fields, size_t count, long line){
+        records.push_back(vector<string>(fields.begin(), fields.begin() + count));
+        lines.push_back(line);
+    }, &stats);
+    parser.feed(input.data(), input.size());
+    parser.finish();
+
+    CHECK_EQ(records.size(), (size_t)3);
+    if (records.size() == 3){
+        CHECK(records[0] == vector<string>({"a", "b \"q\" c", "d"}));
+        CHECK(records[1] == vector<string>({"x", "multi\nline", "z"}));
+        CHECK(records[2] == vector<string>({"last", "a\"b", "open"}));
+        CHECK_EQ(lines[1], 2);
+        CHECK_EQ(lines[2], 5);
+    }
+    CHECK_EQ(stats.reasons[CSV_STRAY_QUOTE], 1);
+    CHECK_EQ(stats.reasons[CSV_UNTERMINATED_QUOTE], 1);
+
+    //empty fields and trailing comma
+    records.clear();
+    csvParser second([&](const vector<string>& fields, size_t count, long){
+        records.push_back(vector<string>(fields.begin(), fields.begin() + count));
+    }, &stats);
+    string empties = ",,\"\",\n";
+    second.feed(empties.data(), empties.size());
+    second.finish();
+    CHECK_EQ(records.size(), (size_t)1);
+    if (records.size() == 1)
+        CHECK(records[0] == vector<string>({"", "", "", ""}));
+}
+
+static void testParseLength(){
+    float length = -1;
+    CHECK(parseLength("8.0", length) && length == 8.0f);
+    CHECK(parseLength(" 12.5 ", length) && length == 12.5f);
+    CHECK(parseLength("", length) && length == 0.0f);
+    CHECK(!parseLength("abc", length));
+    CHECK(!parseLength("5s", length));
+    CHECK(!parseLength("-3", length));
+}
+
+static void testParseTranscriptRow(){
+    csvStats stats;
+    transcriptRow row;
+
+    vector<string> good = {"2020-02-25", "Debate", "Part 1", "Gayle King", "Hello there.", "22.0"};
+    CHECK(parseTranscriptRow(good, 6, row, stats));
+    CHECK_EQ(row.speaker, string("Gayle King"));
+    CHECK_EQ(row.length, 22.0f);
+
+    vector<string> missing = {"2020-02-25", "Debate", "Part 1", "Gayle King", "Hello there.", ""};
+    CHECK(parseTranscriptRow(missing, 6, row, stats));
+    CHECK_EQ(stats.reasons[CSV_MISSING_LENGTH], 1);
+
+    vector<string> noSpeaker = {"2020-02-25", "Debate", "Part 1", "", "Hello.", "1"};
+    CHECK(!parseTranscriptRow(noSpeaker, 6, row, stats));
+    CHECK_EQ(stats.reasons[CSV_BAD_SPEAKER], 1);
+
+    vector<string> badDate = {"02-25-2020", "Debate", "Part 1", "A", "Hello.", "1"};
+    CHECK(!parseTranscriptRow(badDate, 6, row, stats));
+    CHECK_EQ(stats.reasons[CSV_BAD_DATE], 1);
+
+    CHECK(!parseTranscriptRow(good, 5, row, stats));
+    CHECK_EQ(stats.reasons[CSV_FIELD_COUNT], 1);
+
+    CHECK_EQ(stats.records, 5);
+    CHECK_EQ(stats.accepted, 2);
+    CHECK_EQ(stats.rejected, 3);
+}
+
+static void testCountWord(){
+    speech sp;
+    CHECK_EQ(sp.countWord("Good evening and welcome."), 4);
+    CHECK_EQ(sp.countWord("Thank you, Senator."), 3);
+    CHECK_EQ(sp.countWord(""), 0);
+}
+
+static void testAddSpeech(){
+    event e("Test Debate", "2020-01-01");
+    e.addSpeech(speech(1, "A", "One two three.", 10.0));
+    e.addSpeech(speech(2, "B", "Four five.", 5.0));
+    e.addSpeech(speech(3, "A", "Six.", 2.0));
+
+    CHECK_EQ(e.getSpeechCount(), 3);
+    CHECK_EQ(e.getSpeakerCount(), 2);
+    CHECK_EQ(e.getWordCount(), 6);
+    CHECK_EQ(e.getTotalTime(), 17);
+
+    map<string, speakerStats> speakers = e.getSpeakers();
+    CHECK_EQ(speakers["A"].timesSpoke, 2);
+    CHECK_EQ(speakers["A"].totalWordCount, 4);
+    CHECK_EQ(speakers["A"].totalSpeakingTime, 12);
+    CHECK_EQ(speakers["B"].timesSpoke, 1);
+
+    CHECK_EQ(e.getSpeeches().front().getScript(), string("Six."));
+}
+
+static void testScriptStore(){
+    for (string raw : {string(""), string("a"), string("abcd"), string(5000, 'x'), string("to be or not to be, to be or not to be")}){
+        CHECK(scriptStore::decompress(scriptStore::compress(raw), raw.size()) == raw);
+    }
+    CHECK(scriptStore::decompress("\x05" "ab", 5).empty()); //truncated input
+
+    scriptStore store(1);
+    scriptHandle first = store.add("first script");
+    scriptHandle second = store.add("second");
+    CHECK(store.view(first) == "first script"); //open block
+    store.seal();
+    scriptHandle third = store.add("third");
+    store.seal();
+
+    CHECK(store.view(second) == "second");
+    CHECK(store.view(third) == "third");
+    CHECK(store.view(first) == "first script");
+    CHECK_EQ(store.getBlockCount(), 2);
+    CHECK_EQ(store.getStats().cacheMisses, (size_t)3); //capacity 1 evicts on every switch
+    CHECK(store.view(scriptHandle()).empty());
+
+    //spilled blocks read back from disk, including blocks sealed after the spill
+    size_t held = store.memoryBytes();
+    CHECK(store.spill());
+    CHECK(store.isSpilling());
+    CHECK(store.memoryBytes() < held);
+    scriptHandle fourth = store.add("fourth script");
+    store.seal();
+    CHECK(store.view(first) == "first script");
+    CHECK(store.view(fourth) == "fourth script");
+    CHECK_EQ(store.getStats().spilledBytes, store.getStats().compressedBytes);
+
+    //dropped scripts come back empty
+    store.setDropping(true);
+    scriptHandle dropped = store.add("gone");
+    CHECK(store.view(dropped).empty());
+    CHECK_EQ(store.getStats().droppedBytes, (size_t)4);
+    store.clear();
+    CHECK(!store.isSpilling() && !store.isDropping());
+
+    //a spill file that cannot be read back leaves its blocks blank
+    scriptStore broken(1);
+    int spillFd = dup(0); //the spill file will get the lowest free descriptor
+    close(spillFd);
+    broken.add("kept");
+    scriptHandle lost = broken.add("lost script");
+    broken.seal();
+    CHECK(broken.spill());
+    int empty = open("/dev/null", O_RDONLY); //swap the file for one that reads nothing
+    CHECK_EQ(dup2(empty, spillFd), spillFd);
+    close(empty);
+    CHECK(broken.view(lost).empty());
+}
+
+static void testSketches(){
+    //exact while small
+    quantileSketch small;
+    for (int i = 1; i <= 100; i++)
+        small.add(i);
+    CHECK_EQ(small.quantile(0.5), 50.0f);
+    CHECK_EQ(small.quantile(0.9), 90.0f);
+    CHECK_EQ(small.getMax(), 100.0f);
+    CHECK_EQ(small.getMin(), 1.0f);
+
+    //the sorted items quantile keeps are dropped by the next add or merge
+    small.add(1000);
+    CHECK_EQ(small.quantile(0.999), 1000.0f);
+    quantileSketch larger;
+    for (int i = 0; i < 101; i++)
+        larger.add(2000);
+    small.merge(larger);
+    CHECK_EQ(small.quantile(0.9), 2000.0f);
+
+    //bounded memory and rank error on a large stream, split across two merged sketches
+    quantileSketch a, b;
+    vector<float> values;
+    mt19937 rng(7);
+    for (int i = 0; i < 200000; i++){
+        float value = rng() % 100000;
+        values.push_back(value);
+        (i % 2 ? a : b).add(value);
+    }
+    a.merge(b);
+    sort(values.begin(), values.end());
+
+    CHECK_EQ(a.getCount(), 200000L);
+    CHECK(a.getRetained() < 2000);
+    size_t outOfOrder = 0;
+    for (double q = 0.001; q <= 1.0; q += 0.001)
+        outOfOrder += a.quantile(q) < a.quantile(q - 0.001) ? 1 : 0;
+    CHECK_EQ(outOfOrder, (size_t)0);
+    for (double q : {0.5, 0.9, 0.99}){
+        size_t rank = lower_bound(values.begin(), values.end(), a.quantile(q)) - values.begin();
+        CHECK(fabs((double)rank / values.size() - q) < 0.02);
+    }
+
+    quantileSketch empty;
+    CHECK_EQ(empty.quantile(0.5), 0.0f);
+
+    logHistogram histogram;
+    for (float value : {0.5f, 1.0f, 2.0f, 3.0f, 100000.0f})
+        histogram.add(value);
+    CHECK_EQ(histogram.getBucket(0), 1L);
+    CHECK_EQ(histogram.getBucket(1), 1L);
+    CHECK_EQ(histogram.getBucket(2), 2L);
+    CHECK_EQ(histogram.getBucket(logHistogram::BUCKETS - 1), 1L);
+
+    //event and speaker distributions are updated by addSpeech
+    event e("Test Debate", "2020-01-01");
+    e.addSpeech(speech(1, "A", "One two three.", 10.0));
+    e.addSpeech(speech(2, "A", "Four.", 2.0));
+    CHECK_EQ(e.getTurns().words.getCount(), 2L);
+    CHECK_EQ(e.getSpeakers().at("A").turns.time.getMax(), 10.0f);
+}
+
+static void testPace(){
+    event e("Test Debate", "2020-01-01");
+    e.addSpeech(speech(1, "A", "One two three four five six seven eight nine ten.", 4.5), "Part 1"); //133 wpm
+    e.addSpeech(speech(2, "A", "One two three four five six seven eight nine ten.", 0.0), "Part 1"); //no length
+    e.addSpeech(speech(3, "B", "One two three four five six seven eight nine ten.", 1.0), "Part 2"); //600 wpm
+    e.addSpeech(speech(4, "B", "One two three four five.", 2.5), "Part 2");                          //120 wpm
+
+    CHECK_EQ(e.getTotalTime(), 8.0f);
+    CHECK(e.getSpeeches().front().getPace() == 120.0f);
+    CHECK(!e.getSpeeches().front().isPaceOutlier());
+    CHECK(speech::paceOutlier(10, 0.0));
+    CHECK(speech::paceOutlier(10, 1.0));
+    CHECK(speech::paceOutlier(1, 60.0));
+
+    paceTotals pace = e.getPace();
+    CHECK_EQ(pace.turns, 4);
+    CHECK_EQ(pace.flagged, 2);
+    CHECK_EQ(pace.words, 15);
+    CHECK_EQ(pace.time, 7.0f);
+
+    CHECK(e.getSections() == vector<string>({"Part 1", "Part 2"}));
+    CHECK_EQ(e.getSectionPace(0).flagged, 1);
+    CHECK_EQ(e.getSectionPace(1).words, 5);
+    CHECK(fabs(e.getSectionPace(1).wordsPerMinute() - 120.0f) < 0.01);
+
+    map<string, speakerStats> speakers = e.getSpeakers();
+    CHECK_EQ(speakers["A"].pace.flagged, 1);
+    CHECK_EQ(speakers["A"].totalSpeakingTime, 4.5f);
+    CHECK(fabs(speakers["A"].pace.wordsPerMinute() - 10 * 60 / 4.5) < 0.01);
+}
+
+static void testPager(){
+    ostringstream out;
+    vector<int> order = {2, 0, 1};
+    vector<string> names = {"a", "b", "c"};
+    int formatted = 0;
+
+    pager table(out, 2);
+    table.setTable("HEADER\n", order.size(), [&](string& buffer, int i){
+        formatted++;
+        appendf(buffer, "%d:%s\n", i + 1, names[order[i]].c_str());
+    });
+
+    CHECK_EQ(table.getPageCount(), 2);
+    table.render();
+    CHECK(table.getBuffer().find("HEADER\n1:c\n2:a\n") == 0);
+    CHECK_EQ(formatted, 2); //only visible rows are formatted
+
+    CHECK(table.nextPage());
+    CHECK(!table.nextPage());
+    table.render();
+    CHECK(table.getBuffer().find("3:b\n") != string::npos);
+    CHECK(table.getBuffer().find("1:c") == string::npos);
+
+    CHECK(table.jumpToRank(1));
+    CHECK_EQ(table.getPage(), 0);
+    CHECK(!table.jumpToRank(4));
+    CHECK(!table.prevPage());
+
+    //scripted browsing: next, jump, done
+    istringstream commands("N\n1\nX\n");
+    out.str("");
+    table.browse(commands);
+    CHECK_EQ(table.getPage(), 0);
+    CHECK(out.str().find("Page 2 of 2") != string::npos);
+
+    string text;
+    appendf(text, "%-5s|%3d", "ab", 7);
+    CHECK_EQ(text, string("ab   |  7"));
+}
+
+static void testDifferential(){
+    vector<pair<string, string> > corpora;
+
+    ifstream bundled("debate_transcripts_v3_2020-02-26.csv", ios::binary);
+    if (bundled.is_open()){
+        ostringstream text;
+        text << bundled.rdbuf();
+        corpora.push_back({"bundled CSV", text.str()});
+    }
+    else{
+        cout << "Bundled CSV not found; run from the repository root to include it." << endl;
+    }
+    for (unsigned seed = 1; seed <= 5; seed++)
+        corpora.push_back({"synthetic " + to_string(seed), makeCorpus(seed, 500, false)});
+
+    auto paths = ingestPaths();
+
+    //plain corpora: every path must match the reference reader
+    for (auto& corpus : corpora){
+        vector<event*> expected;
+        istringstream in(corpus.second);
+        reference::readStream(in, expected);
+        CHECK(!expected.empty());
+
+        for (auto& path : paths){
+            vector<event*> actual;
+            path.second(corpus.second, actual);
+            CHECK(sameEvents(expected, actual, path.first + " / " + corpus.first));
+            freeEvents(actual);
+        }
+        freeEvents(expected);
+    }
+
+    //RFC 4180 corpora: the reference cannot read these, so paths must match each other
+    for (unsigned seed = 1; seed <= 3; seed++){
+        string csv = makeCorpus(100 + seed, 300, true);
+        vector<event*> expected;
+        paths[0].second(csv, expected);
+
+        int speeches = 0;
+        for (event* e : expected)
+            speeches += e->getSpeechCount();
+        CHECK_EQ(speeches, 300);
+
+        for (size_t p = 1; p < paths.size(); p++){
+            vector<event*> actual;
+            paths[p].second(csv, actual);
+            CHECK(sameEvents(expected, actual, paths[p].first + " / rfc " + to_string(seed)));
+            freeEvents(actual);
+        }
+        freeEvents(expected);
+    }
+}
+
+static void testExporter(){
+    vector<event*> events;
+    csvStats stats;
+    istringstream in(makeCorpus(7, 200, true));
+    ingestTranscripts(in, events, stats);
+    CHECK(!events.empty());
+
+    shared_ptr<exportSet> data = exportSet::build(events, true);
+    const table* speeches = data->find("speeches");
+    CHECK(speeches != nullptr);
+    CHECK_EQ(speeches->rows, (size_t)200);
+
+    //speech rows are in file order and decode through the dictionaries
+    const speech* firstSpeech = nullptr;
+    for (auto& sp : events[0]->getSpeeches())
+        firstSpeech = &sp;
+    const speech& first = *firstSpeech;
+    const table* speakers = data->find("speakers");
+    int32_t code = speeches->find("speaker")->ints[0];
+    CHECK_EQ(speakers->find("name")->getString(code), first.getSpeaker());
+    CHECK_EQ(speeches->find("script")->getString(0), first.getScript());
+    CHECK_EQ(speeches->find("word_count")->ints[0], first.getCount());
+
+    //file roundtrip
+    string path = "bin/test_export.col";
+    CHECK(data->write(path));
+    shared_ptr<exportSet> loaded = exportSet::read(path);
+    CHECK(loaded != nullptr);
+    if (loaded){
+        CHECK_EQ(loaded->getTables().size(), data->getTables().size());
+        for (auto& tbl : data->getTables()){
+            const table* other = loaded->find(tbl.name);
+            CHECK(other != nullptr);
+            if (!other)
+                continue;
+            CHECK_EQ(other->rows, tbl.rows);
+            CHECK_EQ(other->columns.size(), tbl.columns.size());
+            for (size_t c = 0; c < tbl.columns.size() && c < other->columns.size(); c++){
+                CHECK(other->columns[c].ints == tbl.columns[c].ints);
+                CHECK(other->columns[c].floats == tbl.columns[c].floats);
+                CHECK(other->columns[c].offsets == tbl.columns[c].offsets);
+                CHECK(other->columns[c].bytes == tbl.columns[c].bytes);
+                CHECK_EQ(other->columns[c].dictionary, tbl.columns[c].dictionary);
+            }
+        }
+    }
+
+    //malformed files are rejected before anything is allocated for them
+    ifstream written(path, ios::binary);
+    string file((istreambuf_iterator<char>(written)), istreambuf_iterator<char>());
+    written.close();
+    auto rewrite = [&](const string& bytes){
+        ofstream out(path, ios::binary);
+        out << bytes;
+    };
+    string huge = file;
+    //the first table's row count, after the magic, table count and name; times four it wraps to the true byte length
+    uint64_t rows = (1ull << 62) + data->getTables()[0].rows;
+    memcpy(&huge[16 + data->getTables()[0].name.size()], &rows, sizeof(rows));
+    rewrite(huge);
+    CHECK(exportSet::read(path) == nullptr);
+
+    const column* text = nullptr;
+    for (auto& tbl : data->getTables()){
+        for (auto& col : tbl.columns){
+            if (!text && col.type == COL_UTF8 && col.offsets.size() > 2 && col.offsets[1] < col.offsets[2])
+                text = &col;
+        }
+    }
+    CHECK(text != nullptr);
+    if (text){
+        string offsets((const char*)text->offsets.data(), text->offsets.size() * sizeof(int64_t));
+        size_t at = file.find(offsets);
+        CHECK(at != string::npos);
+        if (at != string::npos){
+            string backwards = file;
+            int64_t past = text->offsets[2] + 1; //second offset after the third
+            memcpy(&backwards[at + sizeof(int64_t)], &past, sizeof(past));
+            rewrite(backwards);
+            CHECK(exportSet::read(path) == nullptr);
+        }
+    }
+    remove(path.c_str());
+    CHECK(exportSet::read(path) == nullptr);
+
+    column broken;
+    broken.type = COL_UTF8;
+    broken.bytes = "abcde";
+    broken.offsets = {0, 5, 2};
+    CHECK(broken.getString(0) == "abcde");
+    CHECK(broken.getString(1).empty());
+
+    //Arrow export shares the column buffers and outlives the set it came from
+    ArrowSchema schema;
+    ArrowArray array;
+    CHECK(!data->exportArrow("missing", &schema, &array));
+    CHECK(data->exportArrow("speeches", &schema, &array));
+    const int32_t* words = speeches->find("word_count")->ints.data();
+    int64_t scriptBytes = speeches->find("script")->bytes.size();
+    data.reset();
+
+    CHECK_EQ(string(schema.format), string("+s"));
+    CHECK_EQ(schema.n_children, array.n_children);
+    CHECK_EQ(array.length, (int64_t)200);
+    for (int64_t c = 0; c < schema.n_children; c++){
+        ArrowSchema* child = schema.children[c];
+        CHECK_EQ(array.children[c]->length, (int64_t)200);
+        if (string(child->name) == "speaker"){
+            CHECK_EQ(string(child->format), string("i"));
+            CHECK(child->dictionary != nullptr);
+            CHECK_EQ(string(child->dictionary->format), string("U"));
+            CHECK(array.children[c]->dictionary->length > 0);
+        }
+        if (string(child->name) == "script"){
+            CHECK_EQ(array.children[c]->n_buffers, (int64_t)3);
+            const int64_t* offsets = (const int64_t*)array.children[c]->buffers[1];
+            CHECK_EQ(offsets[0], (int64_t)0);
+            CHECK_EQ(offsets[array.children[c]->length], scriptBytes);
+        }
+        if (string(child->name) == "word_count")
+            CHECK(array.children[c]->buffers[1] == words);
+    }
+    schema.release(&schema);
+    array.release(&array);
+    CHECK(schema.release == nullptr && array.release == nullptr);
+
+    freeEvents(events);
+}
+
+static void testAliases(){
+    CHECK_EQ(aliasResolver::tidy("  Sec.   Castro "), string("Castro"));
+    CHECK_EQ(aliasResolver::normalize("Senator  Amy\tKlobuchar"), string("amy klobuchar"));
+    CHECK_EQ(aliasResolver::normalize("Mayor"), string("mayor")); //nothing follows the title
+    CHECK_EQ(aliasResolver::editDistance("swalwell", "stalwell", 2), 1);
+    CHECK_EQ(aliasResolver::editDistance("abc", "abcdef", 2), 3);
+
+    aliasResolver aliases;
+    istringstream table("# comment\n\nJohn H. = John Hickenlooper\nSec. Castro=Julian Castro\nno equals sign\n");
+    CHECK_EQ(aliases.load(table), 2);
+
+    int castro = aliases.resolve("Julian Castro");
+    CHECK_EQ(aliases.resolve("Sec. Castro"), castro);
+    CHECK_EQ(aliases.resolve("JULIAN  CASTRO"), castro);
+    CHECK_EQ(aliases.resolve("Castro"), castro);
+    CHECK_EQ(aliases.resolve("john h."), aliases.resolve("John Hickenlooper"));
+    CHECK_EQ(aliases.getName(aliases.resolve("john h.")), string("John Hickenlooper"));
+    CHECK_EQ(aliases.getUses(castro), 0); //lookups are not uses
+    aliases.countUse(castro);
+    CHECK_EQ(aliases.getUses(castro), 1);
+
+    //names with no alias keep their spelling; case variants still merge
+    int warren = aliases.resolve("Elizabeth Warren");
+    CHECK_EQ(aliases.resolve("elizabeth warren"), warren);
+    CHECK_EQ(aliases.getName(warren), string("Elizabeth Warren"));
+    CHECK_EQ(aliases.getName(-1), string(""));
+
+    //suggestions: typos, initials and surnames, but not numbered roles
+    auto read = [&](const string& name){ aliases.countUse(aliases.resolve(name)); };
+    for (int i = 0; i < 5; i++)
+        read("Eric Swalwell");
+    read("Eric Stalwell");
+    read("John Hickenlooper");
+    read("J. Hickenlooper");
+    read("Michael Bennet");
+    read("Michael Bennet");
+    read("Bennett");
+    read("Speaker 1");
+    read("Speaker 12");
+    read("Male");
+    read("Female");
+
+    map<string, string> found;
+    for (auto& suggestion : aliases.suggest())
+        found[aliases.getName(suggestion.variant)] = aliases.getName(suggestion.canonical);
+    CHECK_EQ(found["Eric Stalwell"], string("Eric Swalwell"));
+    CHECK_EQ(found["J. Hickenlooper"], string("John Hickenlooper"));
+    CHECK_EQ(found["Bennett"], string("Michael Bennet"));
+    CHECK(found.count("Speaker 1") == 0 && found.count("Speaker 12") == 0);
+    CHECK(found.count("Male") == 0 && found.count("Female") == 0);
+
+    //alias table changes apply to names already cached
+    istringstream more("Eric Stalwell = Eric Swalwell\n");
+    aliases.load(more);
+    CHECK_EQ(aliases.resolve("Eric Stalwell"), aliases.resolve("Eric Swalwell"));
+
+    //speeches built from a name resolve through the shared table
+    speech sp(1, " Joe  Biden", "Hello there.", 2.0);
+    CHECK_EQ(sp.getSpeaker(), string("Joe Biden"));
+    CHECK_EQ(sp.getSpeakerId(), aliasResolver::shared().resolve("Joe Biden"));
+}
+
+static void testConcordance(){
+    //SA-IS and Kasai against sorting the suffixes directly, on small alphabets so there is recursion
+    mt19937 rng(11);
+    for (int trial = 0; trial < 200; trial++){
+        int n = 1 + rng() % 60, K = 2 + rng() % 3;
+        vector<int> s(n + 1);
+        for (int i = 0; i < n; i++)
+            s[i] = 1 + rng() % (K - 1);
+        s[n] = 0;
+
+        vector<int> sa, lcp;
+        concordance::buildSuffixArray(s, sa, K);
+        concordance::buildLcp(s, sa, lcp);
+
+        vector<int> expected(n + 1);
+        iota(expected.begin(), expected.end(), 0);
+        sort(expected.begin(), expected.end(), [&](int a, int b){
+            return lexicographical_compare(s.begin() + a, s.end(), s.begin() + b, s.end());
+        });
+        CHECK(sa == expected);
+
+        bool lcpOk = true;
+        for (int i = 1; i <= n; i++){
+            int h = 0;
+            while (sa[i] + h <= n && sa[i - 1] + h <= n && s[sa[i] + h] == s[sa[i - 1] + h])
+                h++;
+            lcpOk = lcpOk && lcp[i] == h;
+        }
+        CHECK(lcpOk);
+    }
+
+    event* debate = new event("Debate", "2020-01-01");
+    debate->addSpeech(speech(1, "Zed Speaker", "Health care is a right. HEALTH CARE!", 5.0));
+    debate->addSpeech(speech(2, "Amy Speaker", "We need health", 2.0));
+    debate->addSpeech(speech(3, "Amy Speaker", "care for all", 2.0));
+    event* later = new event("Later", "2020-02-01");
+    later->addSpeech(speech(1, "Amy Speaker", "health care, again", 2.0));
+    vector<event*> events = {later, debate};
+
+    concordance index;
+    CHECK(!index.isBuilt());
+    index.build(events);
+    CHECK(index.isBuilt());
+    CHECK(index.memoryBytes() >= index.getLength() * (1 + 2 * sizeof(int))); //text, suffix and LCP arrays
+
+    CHECK_EQ(index.count("health care"), 3); //case-insensitive, never across speeches
+    CHECK_EQ(index.count("health"), 4);
+    CHECK_EQ(index.count("missing"), 0);
+    CHECK_EQ(index.count(""), 0);
+    CHECK_EQ(index.count("health care, again"), 1);
+
+    //grouped by speaker, then date; context stops at the speech's edges
+    vector<kwicLine> lines = index.search("HEALTH CARE", 8);
+    CHECK_EQ(lines.size(), (size_t)3);
+    if (lines.size() == 3){
+        CHECK_EQ(lines[0].speaker, string("Amy Speaker"));
+        CHECK_EQ(lines[0].date, string("2020-02-01"));
+        CHECK_EQ(lines[0].left, string(""));
+        CHECK_EQ(lines[0].right, string(", again"));
+        CHECK_EQ(lines[1].speaker, string("Zed Speaker"));
+        CHECK_EQ(lines[1].match, string("Health care"));
+        CHECK_EQ(lines[2].match, string("HEALTH CARE"));
+        CHECK_EQ(lines[2].left, string(" right. "));
+        CHECK_EQ(lines[2].right, string("!"));
+    }
+
+    istringstream phrases("health care\n\nmissing\n");
+    ostringstream out;
+    CHECK_EQ(index.exportTsv(phrases, out, 5), 3);
+    string tsv = out.str();
+    CHECK(tsv.find("phrase\tspeaker\tdate") == 0);
+    CHECK_EQ(count(tsv.begin(), tsv.end(), '\n'), 4L);
+
+    freeEvents(events);
+}
+
+static void testTimeline(){
+    //events arrive newest first, as in the bundled file
+    string csv = "date,debate_name,debate_section,speaker,speech,speaking_time_seconds\n"
+                 "2020-03-01,Third,Part 1,Ann,One two three,30\n"
+                 "2020-03-01,Third,Part 1,Bob,One,10\n"
+                 "2020-02-01,Second,Part 1,Bob,One two,20\n"
+                 "2020-02-01,Second,Part 1,Ann,One,20\n"
+                 "2020-01-01,First,Part 1,Ann,One,10\n"
+                 "2020-01-01,First,Part 1,Bob,One,30\n"
+                 "2020-01-01,First,Part 1,Cy,One,60\n";
+    vector<event*> events;
+    csvStats stats;
+    timeline seasons;
+    istringstream in(csv);
+    ingestTranscripts(in, events, stats, 1 << 16, &seasons);
+
+    CHECK_EQ(seasons.getEventCount(), 3);
+    CHECK_EQ(seasons.getDate(0), string("2020-01-01"));
+    CHECK_EQ(seasons.getName(2), string("Third"));
+    CHECK_EQ(seasons.getSpeakerCount(0), 3);
+
+    int ann = aliasResolver::shared().resolve("Ann");
+    const speakerSeries* rows = seasons.getSeries(ann);
+    CHECK(rows != nullptr);
+    if (rows){
+        CHECK_EQ(rows->size(), (size_t)3);
+        CHECK(rows->slot == vector<int>({0, 1, 2}));
+        CHECK(rows->words == vector<int>({0, 0, 2})); //countWord counts the gaps between words
+        CHECK(rows->rank == vector<int>({3, 1, 1}));
+        CHECK(fabs(rows->share[0] - 10.0) < 1e-4);
+        CHECK(fabs(rows->share[2] - 75.0) < 1e-4);
+    }
+    //share 10, 50, 75: least-squares slope 32.5 per event
+    CHECK(fabs(seasons.trend(ann) - 32.5) < 1e-3);
+    CHECK(fabs(seasons.delta(ann, 1) - 40.0) < 1e-3);
+    CHECK_EQ(seasons.delta(ann, 0), 0.0f);
+
+    int cy = aliasResolver::shared().resolve("Cy");
+    CHECK(seasons.rankHistory(cy) == vector<int>({1, 0, 0}));
+    CHECK_EQ(seasons.trend(cy), 0.0f);
+    CHECK(seasons.getSeries(-1) == nullptr);
+
+    //the same events through the menu's per-speaker totals
+    int words = 0;
+    for (event* e : events){
+        auto found = e->getSpeakers().find("Ann");
+        if (found != e->getSpeakers().end())
+            words += found->second.totalWordCount;
+    }
+    CHECK_EQ(words, 2);
+
+    freeEvents(events);
+}
+
+static void testCompare(){
+    float a[] = {1, 2, 0, 0}, b[] = {2, 4, 0, 0}, c[] = {0, 0, 3, 1}, zero[] = {0, 0, 0, 0};
+    CHECK(fabs(eventComparer::cosine(a, b, 4) - 1.0) < 1e-6);
+    CHECK_EQ(eventComparer::cosine(a, c, 4), 0.0f);
+    CHECK_EQ(eventComparer::cosine(a, zero, 4), 0.0f);
+
+    float p[] = {0.5, 0.5, 0, 0}, q[] = {1, 0, 0, 0}, r[] = {0, 0, 0.25, 0.75};
+    CHECK(fabs(eventComparer::jensenShannon(p, p, 4)) < 1e-4);
+    CHECK(fabs(eventComparer::jensenShannon(p, r, 4) - 1.0) < 1e-4);
+    CHECK(fabs(eventComparer::jensenShannon(p, q, 4) - 0.311278) < 1e-4);
+    CHECK(fabs(eventComparer::jensenShannon(p, q, 4) - eventComparer::jensenShannon(q, p, 4)) < 1e-6);
+    CHECK_EQ(eventComparer::jensenShannon(p, zero, 4), 1.0f);
+
+    //longer than one vector register, with a remainder
+    vector<float> x(1001), y(1001);
+    for (int i = 0; i < 1001; i++){
+        x[i] = (i % 7) / 3003.0;
+        y[i] = ((i * 5) % 11) / 5005.0;
+    }
+    double dot = 0, nx = 0, ny = 0;
+    for (int i = 0; i < 1001; i++){
+        dot += x[i] * y[i];
+        nx += x[i] * x[i];
+        ny += y[i] * y[i];
+    }
+    CHECK(fabs(eventComparer::cosine(x.data(), y.data(), 1001) - dot / sqrt(nx * ny)) < 1e-5);
+
+    event* first = new event("First", "2020-01-01");
+    first->addSpeech(speech(1, "Pat Compare", "alpha beta gamma", 30.0));
+    first->addSpeech(speech(2, "Lee Compare", "alpha beta", 10.0));
+    event* second = new event("Second", "2020-02-01");
+    second->addSpeech(speech(1, "Pat Compare", "delta epsilon", 10.0));
+    second->addSpeech(speech(2, "Lee Compare", "delta", 30.0));
+    vector<event*> events = {first, second};
+
+    eventComparer comparer;
+    CHECK(!comparer.isBuilt());
+    comparer.build(events);
+    CHECK_EQ(comparer.getEventCount(), 2);
+    CHECK_EQ(comparer.indexOf(second), 1);
+    CHECK_EQ(comparer.indexOf(nullptr), -1);
+
+    int pat = aliasResolver::shared().resolve("Pat Compare");
+    CHECK(fabs(comparer.getShare(0)[pat] - 0.75) < 1e-6);
+    CHECK(fabs(comparer.getShare(1)[pat] - 0.25) < 1e-6);
+    CHECK_EQ(comparer.getTurns(0)[pat], 1.0f);
+
+    similarity pair = comparer.compare(0, 1);
+    CHECK(fabs(pair.speakerCosine - 0.6) < 1e-5); //(0.75, 0.25) . (0.25, 0.75) / 0.625
+    CHECK(pair.vocabJS > 0.99); //no words in common
+    CHECK(fabs(comparer.compare(0, 0).vocabJS) < 1e-4);
+
+    vector<float> matrix = comparer.matrix(SPEAKER_JS);
+    CHECK_EQ(matrix.size(), (size_t)4);
+    CHECK_EQ(matrix[1], matrix[2]);
+    CHECK(fabs(matrix[1] - pair.speakerJS) < 1e-6);
+
+    freeEvents(events);
+}
+
+static void testRoles(){
+    roleModel model;
+    istringstream table("# comment\n"
+                        "Pat Roles = Candidate\n"
+                        "  lee   roles =moderator\n"
+                        "Kim Roles = spectator\n"
+                        "no equals sign\n");
+    CHECK_EQ(model.load(table), 2);
+    CHECK_EQ(model.lookup("PAT ROLES"), (int)ROLE_CANDIDATE);
+    CHECK_EQ(model.lookup("Lee Roles"), (int)ROLE_MODERATOR);
+    CHECK_EQ(model.lookup("Kim Roles"), (int)ROLE_UNKNOWN);
+    CHECK_EQ(model.lookup("Moderator"), (int)ROLE_MODERATOR);
+    CHECK_EQ(model.lookup("Moderator 2"), (int)ROLE_MODERATOR);
+    CHECK_EQ(model.lookup("Moderators Club"), (int)ROLE_UNKNOWN);
+    CHECK_EQ(model.lookup("Audience"), (int)ROLE_OTHER);
+    CHECK_EQ(model.lookup("voiceover"), (int)ROLE_OTHER);
+    CHECK_EQ(model.lookup("Speaker 1"), (int)ROLE_UNKNOWN);
+
+    //the table wins over the turns; unlisted speakers are decided by their questions
+    CHECK_EQ(model.classify("Pat Roles", 10, 10), (int)ROLE_CANDIDATE);
+    CHECK_EQ(model.classify("Speaker 1", 10, 3), (int)ROLE_MODERATOR);
+    CHECK_EQ(model.classify("Speaker 1", 10, 2), (int)ROLE_CANDIDATE);
+    CHECK_EQ(roleModel::parseRole("OTHER"), (int)ROLE_OTHER);
+    CHECK_EQ(string(roleModel::roleName(ROLE_MODERATOR)), string("Moderator"));
+
+    CHECK(roleModel::isQuestion("What is your plan?", 4));
+    CHECK(!roleModel::isQuestion("Here is my plan.", 4));
+    CHECK(!roleModel::isQuestion("A long answer?", QUESTION_MAX_WORDS + 1));
+
+    //a question counts once someone else answers it
+    event ev("Roles", "2020-01-01");
+    ev.addSpeech(speech(1, "Quinn Host", "Welcome. What would you do first?", 5.0));
+    ev.addSpeech(speech(2, "Ray Hopeful", "I would fix the roads and the bridges.", 20.0));
+    ev.addSpeech(speech(3, "Quinn Host", "And why?", 2.0));
+    ev.addSpeech(speech(4, "Quinn Host", "Anyone?", 2.0));
+    ev.addSpeech(speech(5, "Sam Hopeful", "Because we must.", 10.0));
+    ev.addSpeech(speech(6, "Crowd", "Cheering", 3.0));
+    CHECK_EQ(ev.getSpeakers().at("Quinn Host").questions, 2);
+    CHECK_EQ(ev.getSpeakers().at("Sam Hopeful").questions, 0);
+    CHECK_EQ(ev.getSpeakers().at("Ray Hopeful").questions, 0);
+    CHECK_EQ(ev.getRoleCount(ROLE_CANDIDATE), 0);
+
+    ev.assignRoles(model);
+    CHECK_EQ(ev.getSpeakers().at("Quinn Host").role, (int)ROLE_MODERATOR);
+    CHECK_EQ(ev.getSpeakers().at("Ray Hopeful").role, (int)ROLE_CANDIDATE);
+    CHECK_EQ(ev.getSpeakers().at("Crowd").role, (int)ROLE_OTHER);
+    CHECK_EQ(ev.getRoleCount(ROLE_CANDIDATE), 2);
+    const roleTotals& hosts = ev.getRoleTotals(ROLE_MODERATOR);
+    CHECK_EQ(hosts.speakers, 1);
+    CHECK_EQ(hosts.turns, 3);
+    CHECK_EQ(hosts.time, 9.0f);
+
+    //ingest settles every event's roles
+    string csv = "date,debate_name,debate_section,speaker,speech,speaking_time_seconds\n"
+                 "2020-03-01,Third,Part 1,Moderator,Who goes first?,3\n"
+                 "2020-03-01,Third,Part 1,Ann,I do,10\n"
+                 "2020-02-01,Second,Part 1,Audience,Applause,2\n";
+    vector<event*> events;
+    csvStats stats;
+    istringstream in(csv);
+    ingestTranscripts(in, events, stats);
+    CHECK_EQ(events.size(), (size_t)2);
+    CHECK_EQ(events[0]->getRoleCount(ROLE_MODERATOR), 1);
+    CHECK_EQ(events[0]->getRoleCount(ROLE_CANDIDATE), 1);
+    CHECK_EQ(events[1]->getRoleCount(ROLE_OTHER), 1);
+    freeEvents(events);
+}
+
+static void testIngestBudget(){
+    string csv = "date,debate_name,debate_section,speaker,speech,speaking_time_seconds\n";
+    for (int e = 0; e < 4; e++){
+        for (int i = 0; i < 2000; i++){
+            csv += "2020-0" + to_string(e + 1) + "-01,Event,Part 1,Speaker " + to_string(i % 7) + ",Some words spoken in turn " + to_string(i) + ".,5\n";
+        }
+    }
+
+    vector<event*> events;
+    csvStats stats;
+    ingestBudget unlimited;
+    istringstream full(csv);
+    ingestTranscripts(full, events, stats, 1 << 12, nullptr, &unlimited);
+    CHECK(!unlimited.degraded());
+    CHECK(unlimited.peakBytes > 0);
+    CHECK_EQ(unlimited.bytesRead, csv.size());
+    CHECK_EQ(events.size(), (size_t)4);
+    size_t peak = unlimited.peakBytes;
+    freeEvents(events);
+    scriptStore::shared().clear();
+
+    //a budget far below the need walks every step down, yet every event keeps its first row
+    ingestBudget tight;
+    tight.maxBytes = peak / 8;
+    istringstream small(csv);
+    ingestTranscripts(small, events, stats, 1 << 12, nullptr, &tight);
+    CHECK(tight.degraded());
+    CHECK(tight.limitHitAt > tight.maxBytes);
+    CHECK(tight.spilled);
+    CHECK(tight.dropped);
+    CHECK(tight.sampleStride > 1);
+    CHECK(tight.sampledOut > 0);
+    CHECK(!scriptStore::shared().isDropping());
+    CHECK_EQ(events.size(), (size_t)4);
+    CHECK(events.back()->getSpeechCount() < 2000);
+    CHECK(events.back()->getSpeeches().front().getScriptView().empty()); //newest first
+    string_view earliest;
+    for (auto& sp : events.front()->getSpeeches())
+        earliest = sp.getScriptView();
+    CHECK(earliest == "Some words spoken in turn 0.");
+    freeEvents(events);
+    scriptStore::shared().clear();
+
+    //out of time: reading stops after the first chunk
+    ingestBudget hurried;
+    hurried.maxSeconds = 1e-9;
+    istringstream slow(csv);
+    ingestTranscripts(slow, events, stats, 1 << 12, nullptr, &hurried);
+    CHECK(hurried.timedOut);
+    CHECK_EQ(hurried.bytesRead, (size_t)(1 << 12));
+    CHECK(events.size() <= 1);
+    freeEvents(events);
+    scriptStore::shared().clear();
+}
+static void testLexicon(){
+    lexiconSet lexicons;
+    istringstream mood("# comment\nGood 1\nbad -1\ndon't -0.5\n"), topics("health\ncare\ngood 2\n"), empty("# nothing\n");
+    CHECK(lexicons.add("mood", mood));
+    CHECK(lexicons.add("topics", topics));
+    CHECK(!lexicons.add("empty", empty));
+    CHECK_EQ(lexicons.getCount(), 2);
+    CHECK_EQ(lexicons.getWordCount(), (size_t)5);
+    CHECK_EQ(lexicons.getName(1), string("topics"));
+    CHECK_EQ(lexicons.getRejectedLines(), (size_t)0);
+
+    //a weight that is not a whole number drops the line instead of scoring the word as 0 or a prefix
+    lexiconSet typos;
+    istringstream typo("fine\ngood x\nbad -\nwell 2x\ngreat +1.5 \nawful inf\n");
+    CHECK(typos.add("typos", typo));
+    CHECK_EQ(typos.getRejectedLines(), (size_t)4);
+    CHECK_EQ(typos.getWordCount(), (size_t)2);
+    CHECK_EQ(typos.lookup("good"), -1);
+    CHECK_EQ(typos.lookup("well"), -1);
+    int great = typos.lookup("great");
+    CHECK(great >= 0 && typos.getWeights(great)[0] == 1.5f);
+    typos.clear();
+    CHECK_EQ(typos.getRejectedLines(), (size_t)0);
+
+    //a shared word carries a weight in each lexicon
+    int good = lexicons.lookup("good");
+    CHECK(good >= 0);
+    if (good >= 0){
+        CHECK_EQ(lexicons.getWeights(good)[0], 1.0f);
+        CHECK_EQ(lexicons.getWeights(good)[1], 2.0f);
+    }
+    CHECK_EQ(lexicons.lookup("Good"), -1); //callers lowercase
+    CHECK_EQ(lexicons.lookup("goods"), -1);
+    CHECK_EQ(lexicons.lookup(""), -1);
+
+    float scores[2] = {0, 0};
+    lexicons.score("Good health care is not bad. DON'T worry, good.", scores);
+    CHECK_EQ(scores[0], 0.5f); //1 - 1 - 0.5 + 1
+    CHECK_EQ(scores[1], 6.0f); //2 + 1 + 1 + 2
+
+    //every key of a large set lands in its own slot
+    lexiconSet large;
+    string words;
+    for (int i = 0; i < 5000; i++)
+        words += "word" + to_string(i) + " " + to_string(i) + "\n";
+    istringstream list(words);
+    CHECK(large.add("large", list));
+    CHECK(large.getSlotCount() >= large.getWordCount() && large.getSlotCount() < 2 * large.getWordCount());
+    int found = 0;
+    for (int i = 0; i < 5000; i++){
+        int index = large.lookup("word" + to_string(i));
+        found += index >= 0 && large.getWeights(index)[0] == i;
+    }
+    CHECK_EQ(found, 5000);
+    CHECK_EQ(large.lookup("word5000"), -1);
+
+    //threaded scoring matches one thread, and the cache brings the scores back
+    string csv = "date,debate_name,debate_section,speaker,speech,speaking_time_seconds\n";
+    for (int i = 0; i < 1500; i++)
+        csv += string("2020-0") + (i < 700 ? "1" : "2") + "-01,Event,Part 1," + (i % 3 ? "Ann" : "Bob") + "," + (i % 2 ? "Good care." : "Bad bad health.") + ",5\n";
+
+    vector<event*> events;
+    csvStats stats;
+    istringstream in(csv);
+    ingestTranscripts(in, events, stats);
+    scoreEvents(events, lexicons, 1);
+    vector<float> single = events[0]->getScoreColumn();
+    CHECK_EQ(single.size(), (size_t)700 * 2);
+    scoreEvents(events, lexicons, 4);
+    CHECK(events[0]->getScoreColumn() == single);
+    CHECK_EQ(single[0], -2.0f); //first row: "Bad bad health."
+    CHECK_EQ(single[2 + 1], 3.0f); //second row: "Good care."
+
+    float ann = events[1]->getSpeakers().at("Ann").scores[1], bob = events[1]->getSpeakers().at("Bob").scores[1];
+    CHECK_EQ(ann + bob, events[1]->getScores()[1]);
+
+    string path = "test_scores.bin";
+    CHECK(writeScoreCache(path, events, lexicons));
+    vector<float> totals = events[1]->getScores();
+    events[1]->attachScores(vector<float>(), 2);
+    CHECK(readScoreCache(path, events, lexicons));
+    CHECK(events[1]->getScores() == totals);
+    CHECK(!readScoreCache(path, events, large)); //other lexicons
+    CHECK(!readScoreCache(path, vector<event*>(events.begin(), events.begin() + 1), lexicons)); //other events
+    CHECK(!readScoreCache("missing_scores.bin", events, lexicons));
+    freeEvents(events);
+    scriptStore::shared().clear();
+
+    //an edit that keeps every word count and length still changes the text
+    size_t edit = csv.find("Good care.");
+    csv.replace(edit, 10, "Good cure.");
+    istringstream edited(csv);
+    ingestTranscripts(edited, events, stats);
+    CHECK(!readScoreCache(path, events, lexicons));
+    remove(path.c_str());
+
+    freeEvents(events);
+    scriptStore::shared().clear();
+}
+
+int main(){
+    testCsvParser();
+    testParseLength();
+    testParseTranscriptRow();
+    testCountWord();
+    testAddSpeech();
+    testScriptStore();
+    testSketches();
+    testPace();
+    testPager();
+    testDifferential();
+    testExporter();
+    testAliases();
+    testConcordance();
+    testTimeline();
+    testCompare();
+    testRoles();
+    testIngestBudget();
+    testLexicon();
+
+    cout << checks - failures << " of " << checks << " checks passed." << endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}